@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace base {
+
+class Logger;
+
+// spins first, then yields and finally sleeps, used while waiting on lock-free structures
+class Backoff {
+public:
+	void Pause();
+	void Reset() { m_iteration = 0; }
+
+private:
+	static constexpr int SPIN_LIMIT = 64;
+	static constexpr int YIELD_LIMIT = 256;
+	int m_iteration = 0;
+};
+
+// bounded lock-free queue for exactly one producer thread and one consumer thread
+template<typename T>
+class SpscQueue {
+public:
+	explicit SpscQueue(size_t capacity)
+		: m_buffer(capacity + 1), m_bufferSize(capacity + 1) {}
+
+	SpscQueue(const SpscQueue&) = delete;
+	SpscQueue& operator=(const SpscQueue&) = delete;
+
+	bool TryPush(T&& item) {
+		auto tail = m_tail.load(std::memory_order_relaxed);
+		auto next = Increment(tail);
+		if (next == m_head.load(std::memory_order_acquire))
+			return false;
+		m_buffer[tail] = std::move(item);
+		m_tail.store(next, std::memory_order_release);
+		return true;
+	}
+
+	bool TryPop(T& item) {
+		auto head = m_head.load(std::memory_order_relaxed);
+		if (head == m_tail.load(std::memory_order_acquire))
+			return false;
+		item = std::move(m_buffer[head]);
+		m_head.store(Increment(head), std::memory_order_release);
+		return true;
+	}
+
+	// blocks while the queue is full, returns false without pushing when the queue is closed
+	bool Push(T&& item) {
+		Backoff backoff;
+		while (!m_closed.load(std::memory_order_acquire)) {
+			if (TryPush(std::move(item)))
+				return true;
+			backoff.Pause();
+		}
+		return false;
+	}
+
+	// blocks while the queue is empty, returns false once the queue is closed and drained
+	bool Pop(T& item) {
+		Backoff backoff;
+		while (true) {
+			if (TryPop(item))
+				return true;
+			if (m_closed.load(std::memory_order_acquire))
+				return TryPop(item);
+			backoff.Pause();
+		}
+	}
+
+	void Close() { m_closed.store(true, std::memory_order_release); }
+	bool IsClosed() const { return m_closed.load(std::memory_order_acquire); }
+
+	size_t Size() const {
+		auto head = m_head.load(std::memory_order_acquire);
+		auto tail = m_tail.load(std::memory_order_acquire);
+		return tail >= head ? tail - head : tail + m_bufferSize - head;
+	}
+
+	bool Empty() const { return Size() == 0; }
+	size_t Capacity() const { return m_bufferSize - 1; }
+
+private:
+	size_t Increment(size_t index) const { return (index + 1) == m_bufferSize ? 0 : index + 1; }
+
+	std::vector<T> m_buffer;
+	const size_t m_bufferSize;
+	// head is only written by the consumer and tail only by the producer, keep them on separate cache lines
+	alignas(64) std::atomic<size_t> m_head = 0;
+	alignas(64) std::atomic<size_t> m_tail = 0;
+	std::atomic<bool> m_closed = false;
+};
+
+} // namespace base
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace base {
+
+// fixed set of workers with one task deque each, a worker takes its newest task first and steals the oldest task of
+// another worker when its own deque runs dry, tasks submitted from a worker stay on the deque of that worker
+class ThreadPool {
+public:
+	// 0 threads uses the number of hardware threads
+	explicit ThreadPool(size_t threads = 0);
+	// runs the tasks that are still queued, then joins the workers
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	template<typename Func>
+	auto Submit(Func&& func) -> std::future<std::invoke_result_t<std::decay_t<Func>>> {
+		using Result = std::invoke_result_t<std::decay_t<Func>>;
+		// std::function needs a copyable target, the packaged task itself is move only
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+		auto future = task->get_future();
+		Push([task]() { (*task)(); });
+		return future;
+	}
+
+	// calls func(i) for every i in [0, count) and returns once all calls are done, the calling thread runs queued
+	// tasks while it waits, so it may also be called from inside a task
+	// a call that throws does not stop the others, the first exception is rethrown once all of them are done
+	void ParallelFor(size_t count, const std::function<void(size_t)>& func);
+
+	size_t Size() const { return m_workers.size(); }
+	// number of tasks a worker took from the deque of another one
+	size_t GetStolenTaskCount() const { return m_stolen.load(std::memory_order_relaxed); }
+
+private:
+	using Task = std::function<void()>;
+
+	struct WorkQueue {
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	void Push(Task task);
+	// own deque first, then the others starting at the next worker
+	bool TryTake(size_t index, Task& task);
+	void WorkerLoop(size_t index);
+	// index of the worker of this pool running on the calling thread, Size() for other threads
+	size_t CurrentWorker() const;
+
+	std::vector<std::unique_ptr<WorkQueue>> m_queues;
+	std::vector<std::thread> m_workers;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::atomic<size_t> m_pending = 0;
+	std::atomic<size_t> m_nextQueue = 0;
+	std::atomic<size_t> m_stolen = 0;
+	bool m_stopping = false;
+};
+
+} // namespace base
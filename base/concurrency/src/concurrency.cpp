@@ -0,0 +1,22 @@
+#include <thread>
+#include <chrono>
+
+#include "concurrency/concurrency.h"
+
+namespace base {
+
+void
+Backoff::Pause() {
+	if (m_iteration < SPIN_LIMIT) {
+		++m_iteration;
+		return;
+	}
+	if (m_iteration < YIELD_LIMIT) {
+		++m_iteration;
+		std::this_thread::yield();
+		return;
+	}
+	std::this_thread::sleep_for(std::chrono::microseconds(100));
+}
+
+}
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <exception>
+
+#include "concurrency/concurrency.h"
+#include "concurrency/thread-pool.h"
+
+namespace base {
+
+namespace {
+
+// pool and worker index of the calling thread
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local size_t currentIndex = 0;
+
+}
+
+ThreadPool::ThreadPool(size_t threads) {
+	if (threads == 0)
+		threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+	for (size_t i = 0; i < threads; ++i)
+		m_queues.emplace_back(std::make_unique<WorkQueue>());
+	for (size_t i = 0; i < threads; ++i)
+		m_workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_condition.notify_all();
+	for (auto& worker : m_workers)
+		worker.join();
+}
+
+void
+ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& func) {
+	if (count == 0)
+		return;
+	std::atomic<size_t> remaining = count;
+	std::exception_ptr error;
+	std::mutex errorMutex;
+	// queued calls reference this frame, so a throwing call still counts down and the exception waits for the others
+	auto Run = [&func, &remaining, &error, &errorMutex](size_t i) {
+		try {
+			func(i);
+		}
+		catch (...) {
+			std::lock_guard<std::mutex> lock(errorMutex);
+			if (!error)
+				error = std::current_exception();
+		}
+		remaining.fetch_sub(1, std::memory_order_acq_rel);
+	};
+
+	// the last call runs on the calling thread, the others are offered to the workers
+	for (size_t i = 0; i + 1 < count; ++i)
+		Push([&Run, i]() { Run(i); });
+	Run(count - 1);
+
+	// help with whatever is queued instead of blocking, this also keeps nested calls from workers deadlock free
+	const size_t index = CurrentWorker();
+	Backoff backoff;
+	Task task;
+	while (remaining.load(std::memory_order_acquire) > 0) {
+		if (TryTake(index, task)) {
+			task();
+			backoff.Reset();
+		}
+		else {
+			backoff.Pause();
+		}
+	}
+	if (error)
+		std::rethrow_exception(error);
+}
+
+void
+ThreadPool::Push(Task task) {
+	// workers keep their own tasks, other threads spread them round robin
+	size_t index = CurrentWorker();
+	if (index == m_queues.size())
+		index = m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+	{
+		std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+		m_queues[index]->tasks.push_back(std::move(task));
+	}
+	m_pending.fetch_add(1, std::memory_order_release);
+	// taking the lock orders the increment before a worker that is about to wait checks it
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+	}
+	m_condition.notify_one();
+}
+
+bool
+ThreadPool::TryTake(size_t index, Task& task) {
+	const size_t count = m_queues.size();
+	if (index < count) {
+		auto& own = *m_queues[index];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.tasks.empty()) {
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+			m_pending.fetch_sub(1, std::memory_order_acq_rel);
+			return true;
+		}
+	}
+	for (size_t offset = 1; offset <= count; ++offset) {
+		const size_t victim = (index + offset) % count;
+		if (victim == index)
+			continue;
+		auto& queue = *m_queues[victim];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.tasks.empty())
+			continue;
+		task = std::move(queue.tasks.front());
+		queue.tasks.pop_front();
+		m_pending.fetch_sub(1, std::memory_order_acq_rel);
+		if (index < count)
+			m_stolen.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+	return false;
+}
+
+void
+ThreadPool::WorkerLoop(size_t index) {
+	currentPool = this;
+	currentIndex = index;
+	Task task;
+	while (true) {
+		if (TryTake(index, task)) {
+			task();
+			task = nullptr;
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_condition.wait(lock, [this]() { return m_stopping || m_pending.load(std::memory_order_acquire) > 0; });
+		if (m_stopping && m_pending.load(std::memory_order_acquire) == 0)
+			return;
+	}
+}
+
+size_t
+ThreadPool::CurrentWorker() const {
+	return currentPool == this ? currentIndex : m_queues.size();
+}
+
+}
@@ -0,0 +1,144 @@
+#include <catch2/catch.hpp>
+#include <concurrency/concurrency.h>
+#include <concurrency/thread-pool.h>
+#include <logger/logger.h>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+auto concurrencyLogger = std::make_shared<base::Logger>();
+
+TEST_CASE("Spsc Queue Single Thread") {
+	concurrencyLogger << MESSAGE("Spsc Queue Single Thread Test", base::Logger::Severity::Info);
+	base::SpscQueue<int> queue(3);
+	CHECK(queue.Capacity() == 3);
+	CHECK(queue.Empty());
+	CHECK(queue.TryPush(1));
+	CHECK(queue.TryPush(2));
+	CHECK(queue.TryPush(3));
+	CHECK_FALSE(queue.TryPush(4));
+	CHECK(queue.Size() == 3);
+	int value = 0;
+	REQUIRE(queue.TryPop(value));
+	CHECK(value == 1);
+	CHECK(queue.TryPush(4));
+	REQUIRE(queue.TryPop(value));
+	CHECK(value == 2);
+	REQUIRE(queue.TryPop(value));
+	CHECK(value == 3);
+	REQUIRE(queue.TryPop(value));
+	CHECK(value == 4);
+	CHECK_FALSE(queue.TryPop(value));
+	CHECK(queue.Empty());
+}
+
+TEST_CASE("Spsc Queue Move Only Items") {
+	concurrencyLogger << MESSAGE("Spsc Queue Move Only Items Test", base::Logger::Severity::Info);
+	base::SpscQueue<std::unique_ptr<std::string>> queue(2);
+	CHECK(queue.TryPush(std::make_unique<std::string>("first")));
+	CHECK(queue.TryPush(std::make_unique<std::string>("second")));
+	std::unique_ptr<std::string> item;
+	REQUIRE(queue.TryPop(item));
+	REQUIRE(item);
+	CHECK(*item == "first");
+	REQUIRE(queue.TryPop(item));
+	CHECK(*item == "second");
+}
+
+TEST_CASE("Spsc Queue Producer Consumer") {
+	concurrencyLogger << MESSAGE("Spsc Queue Producer Consumer Test", base::Logger::Severity::Info);
+	constexpr int count = 100000;
+	base::SpscQueue<int> queue(16);
+	std::thread producer([&]() {
+		for (int i = 0; i < count; ++i) {
+			int item = i;
+			queue.Push(std::move(item));
+		}
+		queue.Close();
+	});
+	int expected = 0;
+	bool ordered = true;
+	int value = 0;
+	while (queue.Pop(value)) {
+		if (value != expected)
+			ordered = false;
+		++expected;
+	}
+	producer.join();
+	CHECK(ordered);
+	CHECK(expected == count);
+}
+
+TEST_CASE("Spsc Queue Close") {
+	concurrencyLogger << MESSAGE("Spsc Queue Close Test", base::Logger::Severity::Info);
+	base::SpscQueue<int> queue(1);
+	int item = 1;
+	CHECK(queue.Push(std::move(item)));
+	queue.Close();
+	CHECK(queue.IsClosed());
+	item = 2;
+	CHECK_FALSE(queue.Push(std::move(item)));
+	int value = 0;
+	// items pushed before closing are still delivered
+	REQUIRE(queue.Pop(value));
+	CHECK(value == 1);
+	CHECK_FALSE(queue.Pop(value));
+}
+
+
+TEST_CASE("Thread Pool Submit") {
+	concurrencyLogger << MESSAGE("Thread Pool Submit Test", base::Logger::Severity::Info);
+	base::ThreadPool pool(4);
+	CHECK(pool.Size() == 4);
+	auto answer = pool.Submit([]() { return 42; });
+	CHECK(answer.get() == 42);
+	std::atomic<int> counter = 0;
+	std::vector<std::future<void>> futures;
+	for (int i = 0; i < 1000; ++i)
+		futures.push_back(pool.Submit([&counter]() { counter++; }));
+	for (auto& future : futures)
+		future.get();
+	CHECK(counter == 1000);
+}
+
+TEST_CASE("Thread Pool Parallel For") {
+	concurrencyLogger << MESSAGE("Thread Pool Parallel For Test", base::Logger::Severity::Info);
+	base::ThreadPool pool(4);
+	std::vector<int> values(10000, 0);
+	pool.ParallelFor(values.size(), [&values](size_t i) { values[i] = static_cast<int>(i); });
+	CHECK(std::accumulate(values.begin(), values.end(), 0LL) == 49995000LL);
+	// nested calls from inside tasks must not deadlock
+	std::atomic<int> counter = 0;
+	pool.ParallelFor(8, [&pool, &counter](size_t) {
+		pool.ParallelFor(100, [&counter](size_t) { counter++; });
+	});
+	CHECK(counter == 800);
+	pool.ParallelFor(0, [](size_t) {});
+}
+
+TEST_CASE("Thread Pool Parallel For Exception") {
+	concurrencyLogger << MESSAGE("Thread Pool Parallel For Exception Test", base::Logger::Severity::Info);
+	base::ThreadPool pool(4);
+	std::atomic<int> calls = 0;
+	CHECK_THROWS_AS(pool.ParallelFor(100, [&calls](size_t i) {
+		calls++;
+		if (i % 10 == 3)
+			throw std::runtime_error("task failed");
+	}), std::runtime_error);
+	// the remaining calls still ran and the pool keeps working
+	CHECK(calls == 100);
+	auto future = pool.Submit([]() { return 7; });
+	CHECK(future.get() == 7);
+}
+
+TEST_CASE("Thread Pool Drains On Destruction") {
+	concurrencyLogger << MESSAGE("Thread Pool Drains On Destruction Test", base::Logger::Severity::Info);
+	std::atomic<int> counter = 0;
+	{
+		base::ThreadPool pool(2);
+		for (int i = 0; i < 100; ++i)
+			pool.Submit([&counter]() { counter++; });
+	}
+	CHECK(counter == 100);
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+namespace base {
+
+class Logger;
+
+// read only view of a whole file mapped into memory, pages are loaded by the OS on first access and shared
+// with every other process mapping the same file
+class MappedFile {
+
+public:
+	MappedFile() {}
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	// empty files are opened without a mapping, Data is nullptr then
+	bool Open(const std::string& path);
+	void Close();
+
+	bool IsOpen() const { return m_open; }
+	const char* Data() const { return m_data; }
+	size_t Size() const { return m_size; }
+	const std::string& GetPath() const { return m_path; }
+
+	static std::shared_ptr<base::Logger> GetLogger() { return m_logger; }
+
+private:
+	std::string m_path;
+	const char* m_data = nullptr;
+	size_t m_size = 0;
+	bool m_open = false;
+	// native handles, HANDLE on Windows and the descriptor on other platforms
+	void* m_fileHandle = nullptr;
+	void* m_mappingHandle = nullptr;
+	int m_fileDescriptor = -1;
+	static std::shared_ptr<base::Logger> m_logger;
+};
+
+} // namespace base
@@ -0,0 +1,126 @@
+#include <logger/logger.h>
+#include <utility>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "file/mapped-file.h"
+
+namespace base {
+
+std::shared_ptr<base::Logger> MappedFile::m_logger = std::make_shared<base::Logger>();
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile&
+MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        m_path = std::move(other.m_path);
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_open = std::exchange(other.m_open, false);
+        m_fileHandle = std::exchange(other.m_fileHandle, nullptr);
+        m_mappingHandle = std::exchange(other.m_mappingHandle, nullptr);
+        m_fileDescriptor = std::exchange(other.m_fileDescriptor, -1);
+    }
+    return *this;
+}
+
+bool
+MappedFile::Open(const std::string& path) {
+    Close();
+    m_path = path;
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::string logMsg = "File " + path + " can not be opened for mapping";
+        m_logger->LogError(logMsg.c_str());
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        return false;
+    }
+    m_fileHandle = file;
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+    if (m_size > 0) {
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping == NULL) {
+            std::string logMsg = "File " + path + " can not be mapped";
+            m_logger->LogError(logMsg.c_str());
+            Close();
+            return false;
+        }
+        m_mappingHandle = mapping;
+        m_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+#else
+    int fileDescriptor = open(path.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        std::string logMsg = "File " + path + " can not be opened for mapping";
+        m_logger->LogError(logMsg.c_str());
+        return false;
+    }
+    struct stat fileStat;
+    if (fstat(fileDescriptor, &fileStat) != 0) {
+        close(fileDescriptor);
+        return false;
+    }
+    m_fileDescriptor = fileDescriptor;
+    m_size = static_cast<size_t>(fileStat.st_size);
+    if (m_size > 0) {
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        if (data != MAP_FAILED) {
+            // model files are parsed front to back right after mapping
+            madvise(data, m_size, MADV_SEQUENTIAL);
+            m_data = static_cast<const char*>(data);
+        }
+    }
+#endif
+    if (m_size > 0 && m_data == nullptr) {
+        std::string logMsg = "File " + path + " can not be mapped";
+        m_logger->LogError(logMsg.c_str());
+        Close();
+        return false;
+    }
+    m_open = true;
+    return true;
+}
+
+void
+MappedFile::Close() {
+#ifdef _WIN32
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    if (m_mappingHandle)
+        CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+    if (m_fileHandle)
+        CloseHandle(static_cast<HANDLE>(m_fileHandle));
+#else
+    if (m_data)
+        munmap(const_cast<char*>(m_data), m_size);
+    if (m_fileDescriptor >= 0)
+        close(m_fileDescriptor);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+    m_fileHandle = nullptr;
+    m_mappingHandle = nullptr;
+    m_fileDescriptor = -1;
+}
+
+} // namespace base
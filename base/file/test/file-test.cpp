@@ -1,5 +1,7 @@
 #include <catch2/catch.hpp>
 #include <file/file.h>
+#include <file/mapped-file.h>
+#include <fstream>
 #include <logger/logger.h>
 
 auto fileLogger = std::make_shared<base::Logger>();
@@ -32,4 +34,38 @@ TEST_CASE("Add & Remove Files and Directories") {
 	CHECK(base::File::FileExists(newFile) == false);
 	CHECK(base::File::Remove_Directory(newDir) == true);
 	CHECK(base::File::DirectoryExists(newDir) == false);
+}
+
+TEST_CASE("Map File") {
+	fileLogger << MESSAGE("Map File Test", base::Logger::Severity::Info);
+	auto newFile = base::File::GetExecutableDirectory() / "mapped.bin";
+	std::string content = "mapped file content";
+	{
+		std::ofstream out(newFile, std::ios::binary);
+		out << content;
+	}
+	base::MappedFile mappedFile;
+	CHECK(mappedFile.Open(newFile) == true);
+	CHECK(mappedFile.IsOpen() == true);
+	REQUIRE(mappedFile.Size() == content.size());
+	CHECK(std::string(mappedFile.Data(), mappedFile.Size()) == content);
+
+	base::MappedFile movedFile = std::move(mappedFile);
+	CHECK(mappedFile.IsOpen() == false);
+	CHECK(mappedFile.Data() == nullptr);
+	CHECK(std::string(movedFile.Data(), movedFile.Size()) == content);
+	movedFile.Close();
+	CHECK(movedFile.IsOpen() == false);
+	CHECK(base::File::Remove_File(newFile) == true);
+
+	auto emptyFile = base::File::GetExecutableDirectory() / "empty.bin";
+	CHECK(base::File::Create_File(emptyFile) == true);
+	CHECK(movedFile.Open(emptyFile) == true);
+	CHECK(movedFile.Size() == 0);
+	CHECK(movedFile.Data() == nullptr);
+	movedFile.Close();
+	CHECK(base::File::Remove_File(emptyFile) == true);
+
+	auto missingFile = base::File::GetExecutableDirectory() / "missing.bin";
+	CHECK(movedFile.Open(missingFile) == false);
 }
\ No newline at end of file
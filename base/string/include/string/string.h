@@ -52,6 +52,11 @@ public:
     static std::string
     ReplaceAll(T1 input, T2 replaceOld, T3 replaceNew);
 
+    // escapes the input for a JSON string literal, quotes, backslashes and control characters
+    template<typename T>
+    static std::string
+    EscapeJson(T input);
+
 private:
     static std::shared_ptr<base::Logger> m_logger;
 };
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <cstdio>
 #include <stdexcept>
 #include <limits>
 #include <sstream>
@@ -224,6 +225,41 @@ String::ReplaceAll(T1 input, T2 replaceOld, T3 replaceNew) {
     }
 }
 
+template<typename T>
+std::string
+String::EscapeJson(T input) {
+    if (std::is_same<T, std::string>::value || std::is_same<T, const char*>::value) {
+        std::string inputStr(input);
+        std::string result;
+        result.reserve(inputStr.size());
+        for (char c : inputStr) {
+            switch (c) {
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\b': result += "\\b"; break;
+            case '\f': result += "\\f"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char code[7];
+                    std::snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned char>(c));
+                    result += code;
+                }
+                else {
+                    result += c;
+                }
+            }
+        }
+        return result;
+    }
+    else {
+        m_logger << MESSAGE("Input arguments must be either type of std::string or const char*", base::Logger::Severity::Error);
+        return "";
+    }
+}
+
 void TempFunc() {
     std::string str1 = "";
     const char* str2 = "";
@@ -245,6 +281,9 @@ void TempFunc() {
     base::String::ToUpperCase<std::string>(str1);
     base::String::ToUpperCase<const char*>(str2);
 
+    base::String::EscapeJson<std::string>(str1);
+    base::String::EscapeJson<const char*>(str2);
+
     base::String::ReplaceAll<std::string, std::string, std::string>(str1, str1, str1);
     base::String::ReplaceAll<std::string, std::string, const char*>(str1, str1, str2);
     base::String::ReplaceAll<std::string, const char*, std::string>(str1, str2, str1);
@@ -185,4 +185,15 @@ TEST_CASE("Replace Strings") {
 	auto test2Ws = base::String::ReplaceAll(test2Fixed, "Workspace", "WS");
 	CHECK(test1Ws == "D:/WS/Test/Project1");
 	CHECK(test2Ws == "D:/WS/Test/Project2");
+}
+
+TEST_CASE("Escape Json") {
+	stringLogger << MESSAGE("Escape Json Test", base::Logger::Severity::Info);
+	std::string test1 = "D:\\Workspace\\\"Test\"";
+	const char* test2 = "line1\nline2\ttab\r\b\f";
+	CHECK(base::String::EscapeJson(test1) == "D:\\\\Workspace\\\\\\\"Test\\\"");
+	CHECK(base::String::EscapeJson(test2) == "line1\\nline2\\ttab\\r\\b\\f");
+	CHECK(base::String::EscapeJson(std::string("a\x01" "b\x1f" "c\x7f")) == "a\\u0001b\\u001fc\x7f");
+	CHECK(base::String::EscapeJson(std::string("caf\xc3\xa9")) == "caf\xc3\xa9");
+	CHECK(base::String::EscapeJson(std::string()).empty());
 }
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <object-detection/object-detection.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace base {
+	class Logger;
+}
+
+namespace dl {
+
+struct BatchingParameters {
+	size_t maxBatchSize = 8;
+	// a request waits at most this long for others to share its forward pass
+	double maxWaitMs = 5.0;
+};
+
+struct BatchingStatistics {
+	size_t requests = 0;
+	size_t batches = 0;
+	double averageBatchSize = 0.0;
+	double averageWaitMs = 0.0;
+};
+
+// collects the detection requests of many threads, e.g. one per video stream, and runs them through the detector
+// in batches of one forward pass, a batch is sent when it is full or its oldest request waited maxWaitMs
+class DetectionBatcher {
+public:
+	DetectionBatcher(std::shared_ptr<BaseDetector> detector, BatchingParameters params = BatchingParameters());
+	~DetectionBatcher();
+
+	DetectionBatcher(const DetectionBatcher&) = delete;
+	DetectionBatcher& operator=(const DetectionBatcher&) = delete;
+
+	// runs Preprocess, Forward and Postprocess on the context together with the requests of other threads and
+	// blocks until it is done, attributes are not estimated
+	void Detect(DetectionContext& context);
+
+	std::shared_ptr<BaseDetector> GetDetector() const { return m_detector; }
+	BatchingStatistics GetStatistics() const;
+
+private:
+	struct Request {
+		DetectionContext* context;
+		std::chrono::steady_clock::time_point arrival;
+		std::promise<void> done;
+	};
+
+	void DispatchLoop();
+
+	std::shared_ptr<BaseDetector> m_detector;
+	BatchingParameters m_params;
+	std::deque<std::unique_ptr<Request>> m_requests;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_condition;
+	bool m_stopping = false;
+	std::thread m_dispatcher;
+	std::atomic<size_t> m_requestCount = 0;
+	std::atomic<size_t> m_batchCount = 0;
+	std::atomic<long long> m_waitNs = 0;
+	static std::shared_ptr<base::Logger> m_logger;
+};
+
+}
\ No newline at end of file
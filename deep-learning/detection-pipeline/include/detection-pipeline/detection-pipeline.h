@@ -0,0 +1,109 @@
+#pragma once
+
+#include <object-detection/object-detection.h>
+#include <concurrency/concurrency.h>
+#include <opencv2/videoio.hpp>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace base {
+	class Logger;
+}
+
+namespace dl {
+
+// what the decode stage does when the first queue is full
+enum class QueuePolicy {
+	BLOCK = 1,
+	DROP_NEWEST = 2
+};
+
+struct PipelineParameters {
+	size_t queueCapacity = 4;
+	QueuePolicy inputPolicy = QueuePolicy::BLOCK;
+	std::optional<Object> oneClassNetwork;
+	bool oneObject = false;
+};
+
+struct StageStatistics {
+	std::string name;
+	size_t processed = 0;
+	size_t dropped = 0;
+	double averageLatencyMs = 0.0;
+	double maxLatencyMs = 0.0;
+};
+
+// returns false when there are no frames left
+using FrameSource = std::function<bool(cv::Mat& frame)>;
+// called on the sink thread in frame order, the result is rendered according to the detection parameters
+using FrameSink = std::function<void(size_t frameIndex, DetectionResult& result)>;
+
+// runs decode -> resize/blob -> forward -> decode boxes -> attribute estimation -> sink of a BaseDetector,
+// every stage on its own thread connected by bounded single producer single consumer queues
+class DetectionPipeline {
+public:
+	DetectionPipeline(std::shared_ptr<BaseDetector> detector, PipelineParameters params = PipelineParameters());
+	~DetectionPipeline();
+
+	void Start(const FrameSource& source, const FrameSink& sink);
+	void Start(cv::VideoCapture& capture, const FrameSink& sink);
+	// asks the decode stage to stop, frames already in flight still reach the sink, safe to call from the sink
+	void Stop();
+	// blocks until every stage is finished
+	void Wait();
+	// Start + Wait
+	void Run(cv::VideoCapture& capture, const FrameSink& sink);
+
+	bool IsRunning() const { return m_running.load(); }
+	// last entry holds the end to end latency from decode to the end of the sink
+	std::vector<StageStatistics> GetStatistics() const;
+
+private:
+	enum Stage {
+		DECODE = 0,
+		PREPROCESS = 1,
+		FORWARD = 2,
+		POSTPROCESS = 3,
+		ATTRIBUTES = 4,
+		SINK = 5,
+		END_TO_END = 6,
+		STAGE_COUNT = 7
+	};
+
+	struct PipelineFrame {
+		size_t index = 0;
+		std::chrono::steady_clock::time_point decodeTime;
+		DetectionContext context;
+	};
+
+	struct StageCounters {
+		std::atomic<size_t> processed = 0;
+		std::atomic<size_t> dropped = 0;
+		std::atomic<long long> totalNs = 0;
+		std::atomic<long long> maxNs = 0;
+		void Add(std::chrono::steady_clock::duration duration);
+	};
+
+	using FrameQueue = base::SpscQueue<std::unique_ptr<PipelineFrame>>;
+
+	void DecodeStage(FrameSource source);
+	void SinkStage(FrameSink sink);
+	void RunStage(Stage stage, FrameQueue& input, FrameQueue& output, const std::function<void(PipelineFrame&)>& work);
+
+	std::shared_ptr<BaseDetector> m_detector;
+	PipelineParameters m_params;
+	std::vector<std::unique_ptr<FrameQueue>> m_queues;
+	std::vector<std::thread> m_threads;
+	StageCounters m_counters[STAGE_COUNT];
+	std::atomic<bool> m_stopRequested = false;
+	std::atomic<bool> m_running = false;
+	static std::shared_ptr<base::Logger> m_logger;
+};
+
+}
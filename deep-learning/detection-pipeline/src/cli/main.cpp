@@ -0,0 +1,81 @@
+#include <detection-pipeline/detection-pipeline.h>
+#include <face-detection/face-detection.h>
+#include <object-detection/model-registry.h>
+#include <cxxopts.hpp>
+#include <file/file.h>
+#include <assertion/assertion.h>
+#include <iomanip>
+
+int main(int argc, char** argv) {
+	cxxopts::Options options("Detection Pipeline");
+	options.add_options()
+		("video", "Video path, camera is used when empty", cxxopts::value<std::string>()->default_value("../../../../video-processing/tracking/resource/Faces.mp4"))
+		("queue", "Capacity of the stage queues", cxxopts::value<size_t>()->default_value("4"))
+		("drop", "Drop new frames while the pipeline is saturated")
+		("display", "Show the rendered frames")
+		("models", "Model manifest (root and resource overrides), the repository layout is used when empty", cxxopts::value<std::string>()->default_value(""))
+		("h,help", "Print usage");
+
+	auto result = options.parse(argc, argv);
+	if (result.count("help")) {
+		std::cout << options.help() << std::endl;
+		exit(0);
+	}
+
+	auto videoPath = result["video"].as<std::string>();
+	cv::VideoCapture cap;
+	if (videoPath.empty())
+		cap.open(0);
+	else
+		cap.open(videoPath);
+	if (!cap.isOpened()) {
+		std::cout << "Error opening video source" << std::endl;
+		return -1;
+	}
+
+	auto manifestPath = result["models"].as<std::string>();
+	if (!manifestPath.empty() && !dl::ModelRegistry::LoadManifest(manifestPath)) {
+		std::cout << "Error reading model manifest" << std::endl;
+		return -1;
+	}
+
+	dl::AgeEstimatorProperties ageProp = { dl::AgeEstimatorType::ONNX_200x200, "imageinput", "classoutput" };
+	dl::GenderEstimatorProperties genderProp = { dl::GenderEstimatorType::ONNX_200x200, "imageinput", "classoutput" };
+	dl::EthnicityEstimatorProperties ethnicityProp = { dl::EthnicityEstimatorType::ONNX_200x200, "imageinput", "classoutput" };
+
+	bool display = result.count("display") > 0;
+	auto detector = std::make_shared<dl::FaceDetector>(dl::FaceDetectorType::CAFFE_300x300, ageProp, genderProp, ethnicityProp);
+	dl::ModelRegistry::LogStatistics();
+	dl::DetectionParameters params;
+	params.confidenceThreshold = 0.5;
+	params.renderMode = display ? dl::RenderMode::BOXES : dl::RenderMode::NONE;
+	detector->SetDetectionParameters(params);
+
+	dl::PipelineParameters pipelineParams;
+	pipelineParams.queueCapacity = result["queue"].as<size_t>();
+	pipelineParams.inputPolicy = result.count("drop") ? dl::QueuePolicy::DROP_NEWEST : dl::QueuePolicy::BLOCK;
+	pipelineParams.oneClassNetwork = dl::Object::FACE;
+
+	dl::DetectionPipeline pipeline(detector, pipelineParams);
+	auto start = std::chrono::steady_clock::now();
+	pipeline.Run(cap, [&](size_t frameIndex, dl::DetectionResult& detectionResult) {
+		if (!display)
+			return;
+		cv::imshow("Result", detectionResult.imageWithBbox);
+		if (cv::waitKey(1) == 27)
+			pipeline.Stop();
+	});
+	auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	auto statistics = pipeline.GetStatistics();
+	std::cout << std::left << std::setw(12) << "stage" << std::setw(10) << "frames" << std::setw(10) << "dropped"
+		<< std::setw(12) << "avg [ms]" << std::setw(12) << "max [ms]" << std::endl;
+	for (const auto& stage : statistics) {
+		std::cout << std::left << std::setw(12) << stage.name << std::setw(10) << stage.processed << std::setw(10) << stage.dropped
+			<< std::setw(12) << stage.averageLatencyMs << std::setw(12) << stage.maxLatencyMs << std::endl;
+	}
+	if (seconds > 0.0)
+		std::cout << "Throughput: " << statistics.back().processed / seconds << " FPS" << std::endl;
+
+	return 0;
+}
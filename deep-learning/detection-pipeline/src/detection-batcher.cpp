@@ -0,0 +1,103 @@
+#include <logger/logger.h>
+#include <assertion/assertion.h>
+
+#include "detection-pipeline/detection-batcher.h"
+
+std::shared_ptr<base::Logger> dl::DetectionBatcher::m_logger = std::make_shared<base::Logger>();
+
+namespace dl {
+
+DetectionBatcher::DetectionBatcher(std::shared_ptr<BaseDetector> detector, BatchingParameters params)
+	: m_detector(detector), m_params(params) {
+	ASSERT((m_detector != nullptr), "Detection batcher needs a detector", base::Logger::Severity::Error);
+	ASSERT((m_params.maxBatchSize > 0), "Detection batcher batch size must be positive", base::Logger::Severity::Error);
+	m_dispatcher = std::thread(&DetectionBatcher::DispatchLoop, this);
+}
+
+DetectionBatcher::~DetectionBatcher() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_condition.notify_all();
+	if (m_dispatcher.joinable())
+		m_dispatcher.join();
+}
+
+void
+DetectionBatcher::Detect(DetectionContext& context) {
+	auto request = std::make_unique<Request>();
+	request->context = &context;
+	request->arrival = std::chrono::steady_clock::now();
+	auto done = request->done.get_future();
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_requests.push_back(std::move(request));
+	}
+	m_condition.notify_all();
+	// rethrows what the detector threw for the batch
+	done.get();
+}
+
+BatchingStatistics
+DetectionBatcher::GetStatistics() const {
+	BatchingStatistics stats;
+	stats.requests = m_requestCount.load();
+	stats.batches = m_batchCount.load();
+	if (stats.batches > 0)
+		stats.averageBatchSize = static_cast<double>(stats.requests) / stats.batches;
+	if (stats.requests > 0)
+		stats.averageWaitMs = static_cast<double>(m_waitNs.load()) / stats.requests / 1e6;
+	return stats;
+}
+
+void
+DetectionBatcher::DispatchLoop() {
+	const auto maxWait = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(m_params.maxWaitMs));
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true) {
+		m_condition.wait(lock, [this]() { return m_stopping || !m_requests.empty(); });
+		// requests still queued at shutdown are served before the thread ends
+		if (m_requests.empty())
+			break;
+		auto deadline = m_requests.front()->arrival + maxWait;
+		m_condition.wait_until(lock, deadline, [this]() { return m_stopping || m_requests.size() >= m_params.maxBatchSize; });
+
+		// one forward pass decodes for a single class, requests for another class wait for the next batch
+		std::vector<std::unique_ptr<Request>> batch;
+		auto oneClassNetwork = m_requests.front()->context->oneClassNetwork;
+		for (auto it = m_requests.begin(); it != m_requests.end() && batch.size() < m_params.maxBatchSize;) {
+			if ((*it)->context->oneClassNetwork == oneClassNetwork) {
+				batch.push_back(std::move(*it));
+				it = m_requests.erase(it);
+			}
+			else {
+				++it;
+			}
+		}
+		lock.unlock();
+
+		auto start = std::chrono::steady_clock::now();
+		std::vector<DetectionContext*> contexts;
+		for (const auto& request : batch) {
+			contexts.push_back(request->context);
+			m_waitNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(start - request->arrival).count(), std::memory_order_relaxed);
+		}
+		try {
+			m_detector->DetectContexts(contexts);
+			for (auto& request : batch)
+				request->done.set_value();
+		}
+		catch (...) {
+			std::string logMsg = "Detection batch of " + std::to_string(batch.size()) + " frames failed";
+			m_logger->LogError(logMsg.c_str());
+			for (auto& request : batch)
+				request->done.set_exception(std::current_exception());
+		}
+		m_requestCount.fetch_add(batch.size(), std::memory_order_relaxed);
+		m_batchCount.fetch_add(1, std::memory_order_relaxed);
+		lock.lock();
+	}
+}
+
+}
\ No newline at end of file
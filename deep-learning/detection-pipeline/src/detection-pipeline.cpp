@@ -0,0 +1,185 @@
+#include <logger/logger.h>
+#include <assertion/assertion.h>
+#include <exception>
+
+#include "detection-pipeline/detection-pipeline.h"
+
+std::shared_ptr<base::Logger> dl::DetectionPipeline::m_logger = std::make_shared<base::Logger>();
+
+namespace dl {
+
+void
+DetectionPipeline::StageCounters::Add(std::chrono::steady_clock::duration duration) {
+	auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+	processed.fetch_add(1, std::memory_order_relaxed);
+	totalNs.fetch_add(ns, std::memory_order_relaxed);
+	auto currentMax = maxNs.load(std::memory_order_relaxed);
+	while (ns > currentMax && !maxNs.compare_exchange_weak(currentMax, ns, std::memory_order_relaxed));
+}
+
+DetectionPipeline::DetectionPipeline(std::shared_ptr<BaseDetector> detector, PipelineParameters params)
+	: m_detector(detector), m_params(params) {
+	ASSERT((m_detector != nullptr), "Detection pipeline needs a detector", base::Logger::Severity::Error);
+	ASSERT((m_params.queueCapacity > 0), "Detection pipeline queue capacity must be positive", base::Logger::Severity::Error);
+}
+
+DetectionPipeline::~DetectionPipeline() {
+	Stop();
+	Wait();
+}
+
+void
+DetectionPipeline::Start(const FrameSource& source, const FrameSink& sink) {
+	ASSERT((!m_running.load()), "Detection pipeline is already running", base::Logger::Severity::Error);
+	m_running = true;
+	m_stopRequested = false;
+	for (auto& counters : m_counters) {
+		counters.processed = 0;
+		counters.dropped = 0;
+		counters.totalNs = 0;
+		counters.maxNs = 0;
+	}
+
+	// closed queues can not be reused, every run gets fresh ones
+	m_queues.clear();
+	for (int i = DECODE; i < SINK; ++i)
+		m_queues.emplace_back(std::make_unique<FrameQueue>(m_params.queueCapacity));
+
+	auto detector = m_detector;
+	m_threads.emplace_back(&DetectionPipeline::DecodeStage, this, source);
+	m_threads.emplace_back([this, detector]() {
+		RunStage(PREPROCESS, *m_queues[0], *m_queues[1], [&](PipelineFrame& frame) { detector->Preprocess(frame.context); });
+	});
+	m_threads.emplace_back([this, detector]() {
+		RunStage(FORWARD, *m_queues[1], *m_queues[2], [&](PipelineFrame& frame) { detector->Forward(frame.context); });
+	});
+	m_threads.emplace_back([this, detector]() {
+		RunStage(POSTPROCESS, *m_queues[2], *m_queues[3], [&](PipelineFrame& frame) {
+			detector->Postprocess(frame.context);
+			// blob and raw outputs are not needed anymore, release them before the frame waits in the next queue
+			frame.context.inputBlob.release();
+			frame.context.outputs.clear();
+		});
+	});
+	m_threads.emplace_back([this, detector]() {
+		RunStage(ATTRIBUTES, *m_queues[3], *m_queues[4], [&](PipelineFrame& frame) { detector->EstimateAttributes(frame.context); });
+	});
+	m_threads.emplace_back(&DetectionPipeline::SinkStage, this, sink);
+}
+
+void
+DetectionPipeline::Start(cv::VideoCapture& capture, const FrameSink& sink) {
+	Start([&capture](cv::Mat& frame) { return capture.read(frame) && !frame.empty(); }, sink);
+}
+
+void
+DetectionPipeline::Stop() {
+	m_stopRequested = true;
+}
+
+void
+DetectionPipeline::Wait() {
+	for (auto& thread : m_threads) {
+		if (thread.joinable())
+			thread.join();
+	}
+	m_threads.clear();
+	m_running = false;
+}
+
+void
+DetectionPipeline::Run(cv::VideoCapture& capture, const FrameSink& sink) {
+	Start(capture, sink);
+	Wait();
+}
+
+std::vector<StageStatistics>
+DetectionPipeline::GetStatistics() const {
+	static const char* names[STAGE_COUNT] = { "decode", "preprocess", "forward", "postprocess", "attributes", "sink", "end-to-end" };
+	std::vector<StageStatistics> retVal;
+	for (int i = 0; i < STAGE_COUNT; ++i) {
+		StageStatistics stats;
+		stats.name = names[i];
+		stats.processed = m_counters[i].processed.load();
+		stats.dropped = m_counters[i].dropped.load();
+		if (stats.processed > 0)
+			stats.averageLatencyMs = static_cast<double>(m_counters[i].totalNs.load()) / stats.processed / 1e6;
+		stats.maxLatencyMs = static_cast<double>(m_counters[i].maxNs.load()) / 1e6;
+		retVal.push_back(stats);
+	}
+	return retVal;
+}
+
+void
+DetectionPipeline::DecodeStage(FrameSource source) {
+	auto& output = *m_queues[0];
+	size_t index = 0;
+	while (!m_stopRequested.load()) {
+		auto frame = std::make_unique<PipelineFrame>();
+		auto start = std::chrono::steady_clock::now();
+		if (!source(frame->context.frame))
+			break;
+		m_counters[DECODE].Add(std::chrono::steady_clock::now() - start);
+		frame->index = index++;
+		frame->decodeTime = start;
+		frame->context.oneClassNetwork = m_params.oneClassNetwork;
+		frame->context.oneObject = m_params.oneObject;
+		if (m_params.inputPolicy == QueuePolicy::BLOCK) {
+			if (!output.Push(std::move(frame)))
+				break;
+		}
+		else if (!output.TryPush(std::move(frame))) {
+			// live sources should not fall behind, the newest frame is skipped while the pipeline is saturated
+			m_counters[DECODE].dropped.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+	output.Close();
+}
+
+void
+DetectionPipeline::RunStage(Stage stage, FrameQueue& input, FrameQueue& output, const std::function<void(PipelineFrame&)>& work) {
+	// an exception must not leave the stage thread, the frame is dropped and the stage goes on with the next one
+	auto Drop = [this, stage](const PipelineFrame& frame, const std::string& reason) {
+		std::string logMsg = "Pipeline frame " + std::to_string(frame.index) + " dropped: " + reason;
+		m_logger->LogError(logMsg.c_str());
+		m_counters[stage].dropped.fetch_add(1, std::memory_order_relaxed);
+	};
+
+	std::unique_ptr<PipelineFrame> frame;
+	while (input.Pop(frame)) {
+		auto start = std::chrono::steady_clock::now();
+		try {
+			work(*frame);
+		}
+		catch (const std::exception& e) {
+			Drop(*frame, e.what());
+			continue;
+		}
+		catch (...) {
+			Drop(*frame, "unknown exception");
+			continue;
+		}
+		m_counters[stage].Add(std::chrono::steady_clock::now() - start);
+		// blocking push keeps the backpressure towards the decode stage
+		if (!output.Push(std::move(frame)))
+			break;
+	}
+	output.Close();
+}
+
+void
+DetectionPipeline::SinkStage(FrameSink sink) {
+	auto& input = *m_queues[4];
+	std::unique_ptr<PipelineFrame> frame;
+	while (input.Pop(frame)) {
+		auto start = std::chrono::steady_clock::now();
+		m_detector->Render(frame->context);
+		if (sink)
+			sink(frame->index, frame->context.result);
+		auto end = std::chrono::steady_clock::now();
+		m_counters[SINK].Add(end - start);
+		m_counters[END_TO_END].Add(end - frame->decodeTime);
+	}
+}
+
+}
@@ -0,0 +1,326 @@
+#include <face-detection/face-detection.h>
+#include <instance-segmentation/instance-segmentation.h>
+#include <age-estimator/age-estimator.h>
+#include <gender-estimator/gender-estimator.h>
+#include <ethnicity-estimator/ethnicity-estimator.h>
+#include <datetime/datetime.h>
+#include <string/string.h>
+#include <file/file.h>
+#include <cxxopts.hpp>
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <thread>
+#ifdef _WIN32
+#include <Windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+// one measured configuration, latencies are the durations of single calls in milliseconds
+struct BenchResult {
+	std::string model;
+	cv::Size resolution;
+	int batchSize = 1;
+	int threads = 1;
+	std::vector<double> latencies;
+	double wallSeconds = 0.0;
+	size_t frames = 0;
+	// peak of the configuration alone, only known where the peak of the process can be reset
+	std::optional<size_t> peakRssBytes;
+};
+
+// runs one call of the benchmarked model on the given thread
+using BenchCall = std::function<void(int thread)>;
+
+// high water mark of the resident memory since the start of the process or the last ResetPeakRss
+size_t PeakRssBytes() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.PeakWorkingSetSize;
+	return 0;
+#else
+#ifdef __linux__
+	// ru_maxrss never goes down, VmHWM follows the resets of clear_refs
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line)) {
+		if (line.rfind("VmHWM:", 0) == 0)
+			return static_cast<size_t>(std::stoull(line.substr(6))) * 1024;
+	}
+#endif
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#ifdef __APPLE__
+	return static_cast<size_t>(usage.ru_maxrss);
+#else
+	return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+// largest high water mark before a reset, e.g. while the models were loaded
+size_t peakRssBeforeReset = 0;
+
+// lowers the high water mark to the current resident memory, only Linux can do that, elsewhere the peak stays the
+// one of the whole process
+bool ResetPeakRss() {
+#ifdef __linux__
+	peakRssBeforeReset = std::max(peakRssBeforeReset, PeakRssBytes());
+	std::ofstream clearRefs("/proc/self/clear_refs");
+	clearRefs << "5";
+	clearRefs.close();
+	return !clearRefs.fail();
+#else
+	return false;
+#endif
+}
+
+// nearest rank percentile of sorted samples
+double Percentile(const std::vector<double>& sorted, double percentile) {
+	if (sorted.empty())
+		return 0.0;
+	size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * sorted.size()));
+	return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+std::vector<int> ParseIntegers(const std::string& list) {
+	std::vector<int> retVal;
+	for (const auto& item : base::String::SplitString(list, ","))
+		if (!item.empty())
+			retVal.push_back(std::stoi(item));
+	return retVal;
+}
+
+// "640x360,1280x720" into sizes
+std::vector<cv::Size> ParseResolutions(const std::string& list) {
+	std::vector<cv::Size> retVal;
+	for (const auto& item : base::String::SplitString(list, ",")) {
+		auto parts = base::String::SplitString(item, "x");
+		if (parts.size() == 2)
+			retVal.emplace_back(std::stoi(parts[0]), std::stoi(parts[1]));
+	}
+	return retVal;
+}
+
+// every thread runs its share of the iterations after the warm up calls, fps counts the frames of all threads
+BenchResult Measure(const std::string& model, cv::Size resolution, int batchSize, int threads, int iterations, int warmup, const BenchCall& call) {
+	BenchResult result;
+	result.model = model;
+	result.resolution = resolution;
+	result.batchSize = batchSize;
+	result.threads = threads;
+	const bool peakReset = ResetPeakRss();
+	for (int t = 0; t < threads; ++t)
+		for (int i = 0; i < warmup; ++i)
+			call(t);
+
+	std::vector<std::vector<double>> latencies(threads);
+	const int callsPerThread = std::max(1, iterations / threads);
+	auto worker = [&](int t) {
+		latencies[t].reserve(callsPerThread);
+		for (int i = 0; i < callsPerThread; ++i) {
+			auto begin = std::chrono::steady_clock::now();
+			call(t);
+			auto end = std::chrono::steady_clock::now();
+			latencies[t].push_back(std::chrono::duration<double, std::milli>(end - begin).count());
+		}
+	};
+	auto begin = std::chrono::steady_clock::now();
+	std::vector<std::thread> workers;
+	for (int t = 1; t < threads; ++t)
+		workers.emplace_back(worker, t);
+	worker(0);
+	for (auto& w : workers)
+		w.join();
+	result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+	for (auto& threadLatencies : latencies)
+		result.latencies.insert(result.latencies.end(), threadLatencies.begin(), threadLatencies.end());
+	std::sort(result.latencies.begin(), result.latencies.end());
+	result.frames = result.latencies.size() * batchSize;
+	if (peakReset)
+		result.peakRssBytes = PeakRssBytes();
+	std::cout << model << " " << resolution.width << "x" << resolution.height << " batch " << batchSize << " threads " << threads
+		<< ": p50 " << Percentile(result.latencies, 50.0) << " ms, " << result.frames / result.wallSeconds << " fps" << std::endl;
+	return result;
+}
+
+void WriteJson(std::ostream& os, const std::string& label, const std::vector<BenchResult>& results) {
+	// after resets the current mark only covers the last configuration
+	const size_t processPeakRssBytes = std::max(peakRssBeforeReset, PeakRssBytes());
+	os << "{" << std::endl;
+	os << "  \"label\": \"" << base::String::EscapeJson(label) << "\"," << std::endl;
+	os << "  \"date\": \"" << base::DateTime::GetCurrentDateTimeAsString() << "\"," << std::endl;
+	os << "  \"opencv\": \"" << CV_VERSION << "\"," << std::endl;
+	os << "  \"hardwareThreads\": " << std::thread::hardware_concurrency() << "," << std::endl;
+	os << "  \"processPeakRssBytes\": " << processPeakRssBytes << "," << std::endl;
+	os << "  \"results\": [" << std::endl;
+	for (size_t i = 0; i < results.size(); ++i) {
+		const auto& r = results[i];
+		double mean = 0.0;
+		for (double latency : r.latencies)
+			mean += latency;
+		mean = r.latencies.empty() ? 0.0 : mean / r.latencies.size();
+		os << "    { \"model\": \"" << r.model << "\", \"resolution\": \"" << r.resolution.width << "x" << r.resolution.height << "\""
+			<< ", \"batchSize\": " << r.batchSize << ", \"threads\": " << r.threads << ", \"calls\": " << r.latencies.size()
+			<< ", \"meanMs\": " << mean << ", \"p50Ms\": " << Percentile(r.latencies, 50.0) << ", \"p95Ms\": " << Percentile(r.latencies, 95.0)
+			<< ", \"p99Ms\": " << Percentile(r.latencies, 99.0) << ", \"fps\": " << (r.wallSeconds > 0.0 ? r.frames / r.wallSeconds : 0.0)
+			<< ", \"peakRssBytes\": " << (r.peakRssBytes.has_value() ? std::to_string(r.peakRssBytes.value()) : "null") << " }" << (i + 1 < results.size() ? "," : "") << std::endl;
+	}
+	os << "  ]" << std::endl;
+	os << "}" << std::endl;
+}
+
+// every detector is swept over resolutions, batch sizes and thread counts, concurrent calls lease their own networks
+void BenchmarkDetector(const std::string& model, dl::BaseDetector& detector, std::optional<dl::Object> object, const cv::Mat& image,
+	const std::vector<cv::Size>& resolutions, const std::vector<int>& batchSizes, const std::vector<int>& threadCounts,
+	int iterations, int warmup, std::vector<BenchResult>& results) {
+	for (const auto& resolution : resolutions) {
+		cv::Mat frame;
+		cv::resize(image, frame, resolution);
+		for (int batchSize : batchSizes) {
+			std::vector<cv::Mat> frames(batchSize, frame);
+			for (int threads : threadCounts) {
+				detector.SetMaxConcurrency(threads);
+				results.push_back(Measure(model, resolution, batchSize, threads, iterations, warmup, [&](int) {
+					if (batchSize == 1)
+						detector.Detect(frame, object);
+					else
+						detector.DetectBatch(frames, object);
+				}));
+			}
+		}
+	}
+}
+
+// estimators own a single network, every thread gets an estimator of its own
+template<typename Estimator, typename Type>
+void BenchmarkEstimator(const std::string& model, Type type, const std::string& inputName, const std::string& outputName, const cv::Mat& face,
+	const std::vector<int>& batchSizes, const std::vector<int>& threadCounts, int iterations, int warmup, std::vector<BenchResult>& results) {
+	const int maxThreads = *std::max_element(threadCounts.begin(), threadCounts.end());
+	std::vector<std::unique_ptr<Estimator>> estimators;
+	for (int t = 0; t < maxThreads; ++t)
+		estimators.push_back(std::make_unique<Estimator>(type, inputName, outputName));
+	for (int batchSize : batchSizes) {
+		std::vector<cv::Mat> faces(batchSize, face);
+		for (int threads : threadCounts) {
+			results.push_back(Measure(model, face.size(), batchSize, threads, iterations, warmup, [&](int t) {
+				estimators[t]->EstimateBatch(faces);
+			}));
+		}
+	}
+}
+
+int main(int argc, char** argv) {
+	cxxopts::Options options("Deep Learning Benchmark");
+	options.add_options()
+		("image", "Image the frames are created from", cxxopts::value<std::string>()->default_value("../../../../deep-learning/face-detection/resource/1.jpg"))
+		("resolutions", "Frame resolutions of the detectors", cxxopts::value<std::string>()->default_value("640x360,1280x720,1920x1080"))
+		("batches", "Batch sizes", cxxopts::value<std::string>()->default_value("1,4"))
+		("threads", "Numbers of concurrent callers", cxxopts::value<std::string>()->default_value("1,2,4"))
+		("iterations", "Measured calls per configuration", cxxopts::value<int>()->default_value("50"))
+		("warmup", "Unmeasured calls per thread before each configuration", cxxopts::value<int>()->default_value("2"))
+		("models", "Comma separated subset of face-caffe, face-tensorflow, mask-rcnn, age, gender, ethnicity", cxxopts::value<std::string>()->default_value(""))
+		("label", "Free text stored with the results, e.g. the commit", cxxopts::value<std::string>()->default_value(""))
+		("output", "JSON result file", cxxopts::value<std::string>()->default_value("dl-bench.json"))
+		("h,help", "Print usage");
+
+	auto result = options.parse(argc, argv);
+	if (result.count("help")) {
+		std::cout << options.help() << std::endl;
+		exit(0);
+	}
+
+	auto imagePath = result["image"].as<std::string>();
+	if (!base::File::FileExists(imagePath)) {
+		std::cout << "Image with given path does not exist" << std::endl;
+		exit(0);
+	}
+	cv::Mat image = cv::imread(imagePath.c_str());
+	auto resolutions = ParseResolutions(result["resolutions"].as<std::string>());
+	auto batchSizes = ParseIntegers(result["batches"].as<std::string>());
+	auto threadCounts = ParseIntegers(result["threads"].as<std::string>());
+	if (resolutions.empty() || batchSizes.empty() || threadCounts.empty()) {
+		std::cout << "Resolutions, batch sizes and thread counts must not be empty" << std::endl;
+		exit(0);
+	}
+	const int iterations = result["iterations"].as<int>();
+	const int warmup = result["warmup"].as<int>();
+	auto selected = base::String::SplitString(result["models"].as<std::string>(), ",");
+	auto Enabled = [&selected](const std::string& model) {
+		return selected.empty() || selected.front().empty() || std::find(selected.begin(), selected.end(), model) != selected.end();
+	};
+
+	std::vector<BenchResult> results;
+
+	// face detectors without attribute networks, CAFFE_227x227_AGE and CAFFE_227x227_GENDER have no models registered
+	const std::vector<std::pair<std::string, dl::FaceDetectorType>> faceDetectors = {
+		{ "face-caffe", dl::FaceDetectorType::CAFFE_300x300 },
+		{ "face-tensorflow", dl::FaceDetectorType::TENSORFLOW_300x300 }
+	};
+	for (const auto& [model, type] : faceDetectors) {
+		if (!Enabled(model))
+			continue;
+		dl::FaceDetector detector(type, std::nullopt, std::nullopt, std::nullopt);
+		dl::DetectionParameters params;
+		params.confidenceThreshold = 0.5f;
+		detector.SetDetectionParameters(params);
+		BenchmarkDetector(model, detector, dl::Object::FACE, image, resolutions, batchSizes, threadCounts, iterations, warmup, results);
+	}
+
+	if (Enabled("mask-rcnn")) {
+		dl::InstanceSegmentator segmentator(dl::InstanceSegmentationType::TENSORFLOW_MASK_RCNN);
+		dl::DetectionParameters params;
+		params.inputName = "";
+		params.meanValues = { 0.0, 0.0, 0.0 };
+		params.outputDetectionName = "detection_out_final";
+		params.outputMaskName = "detection_masks";
+		segmentator.SetDetectionParameters(params);
+		BenchmarkDetector("mask-rcnn", segmentator, std::nullopt, image, resolutions, batchSizes, threadCounts, iterations, warmup, results);
+	}
+
+	// estimators get the center square of the image as face crop
+	const int side = std::min(image.cols, image.rows);
+	cv::Mat face = image(cv::Rect((image.cols - side) / 2, (image.rows - side) / 2, side, side)).clone();
+	if (Enabled("age")) {
+		BenchmarkEstimator<dl::AgeEstimator>("age-caffe", dl::AgeEstimatorType::CAFFE_227x227, "data", "prob", face, batchSizes, threadCounts,
+			iterations, warmup, results);
+		BenchmarkEstimator<dl::AgeEstimator>("age-onnx", dl::AgeEstimatorType::ONNX_200x200, "imageinput", "classoutput", face, batchSizes,
+			threadCounts, iterations, warmup, results);
+	}
+	if (Enabled("gender")) {
+		BenchmarkEstimator<dl::GenderEstimator>("gender-caffe", dl::GenderEstimatorType::CAFFE_227x227, "data", "prob", face, batchSizes,
+			threadCounts, iterations, warmup, results);
+		BenchmarkEstimator<dl::GenderEstimator>("gender-onnx", dl::GenderEstimatorType::ONNX_200x200, "imageinput", "classoutput", face,
+			batchSizes, threadCounts, iterations, warmup, results);
+	}
+	if (Enabled("ethnicity")) {
+		BenchmarkEstimator<dl::EthnicityEstimator>("ethnicity-onnx", dl::EthnicityEstimatorType::ONNX_200x200, "imageinput", "classoutput", face,
+			batchSizes, threadCounts, iterations, warmup, results);
+	}
+
+	auto outputPath = result["output"].as<std::string>();
+	std::ofstream output(outputPath);
+	if (!output.is_open()) {
+		std::cout << "Could not open " << outputPath << ", writing the results to the console" << std::endl;
+		WriteJson(std::cout, result["label"].as<std::string>(), results);
+		return 0;
+	}
+	WriteJson(output, result["label"].as<std::string>(), results);
+	std::cout << "Results written to " << outputPath << std::endl;
+
+	return 0;
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <object-detection/object-detection.h>
+#include <object-detection/attribute-network.h>
 #include <map>
 #include <memory>
 #include <optional>
@@ -21,11 +22,19 @@ public:
 	AgeEstimator(AgeEstimatorType type, const std::string& inputName, const std::string& outputName);
 	~AgeEstimator() {}
 	void InitializeNetworkPaths();
-	std::string Estimate(const cv::Mat& face);
+	// labels of the results point into the label table of this estimator
+	AttributeEstimation Estimate(const cv::Mat& face, int topK = 0);
+	// stacks the crops into one blob, results are in the order of the faces
+	std::vector<AttributeEstimation> EstimateBatch(const std::vector<cv::Mat>& faces, int topK = 0);
+	// class scores of an already built NCHW blob, one row per face
+	cv::Mat ForwardBlob(const cv::Mat& inputBlob);
+
+	const NetworkProperties& GetNetworkProperties() const { return m_networkProperties; }
+	const std::vector<std::string>& GetLabels() const { return m_ageList; }
 
 private:
 	AgeEstimatorType m_ageEstimatorType;
-	cv::dnn::Net m_network;
+	std::unique_ptr<AttributeNetwork> m_network;
 	NetworkProperties m_networkProperties;
 	std::map<AgeEstimatorType, NetworkProperties> m_networkPropertiesMap;
 	std::vector<std::string> m_ageList = { "(0-2)", "(4-6)", "(8-12)", "(15-20)", "(25-32)", "(38-43)", "(48-53)", "(60-100)" };
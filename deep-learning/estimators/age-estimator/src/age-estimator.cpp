@@ -5,6 +5,9 @@
 #include <opencv2/imgproc.hpp>
 #include <opencv2/highgui.hpp>
 
+#include <object-detection/attribute-decoder.h>
+#include <object-detection/model-registry.h>
+
 #include "age-estimator/age-estimator.h"
 
 std::shared_ptr<base::Logger> dl::AgeEstimator::m_logger = std::make_shared<base::Logger>();
@@ -20,35 +23,15 @@ AgeEstimator::AgeEstimator(AgeEstimatorType type, const std::string& inputName,
 	if (m_networkProperties.expectedList.has_value())
 		m_ageList = m_networkProperties.expectedList.value();
 
-	switch (m_networkProperties.networkType) {
-	case NetworkType::CAFFE:
-	{
-		m_network = cv::dnn::readNetFromCaffe(m_networkProperties.configFilePath, m_networkProperties.weightFilePath);
-		break;
-	}
-	case NetworkType::TENSORFLOW:
-	{
-		m_network = cv::dnn::readNetFromTensorflow(m_networkProperties.weightFilePath, m_networkProperties.configFilePath);
-		break;
-	}
-	case NetworkType::ONNX:
-	{
-		m_network = cv::dnn::readNetFromONNX(m_networkProperties.weightFilePath);
-		break;
-	}
-	default:
-	{
-		break;
-	}
-	}
+	m_network = std::make_unique<AttributeNetwork>(m_networkProperties, m_inputName);
 }
 
 void
 AgeEstimator::InitializeNetworkPaths() {
 	// CAFFE_227x227 AGE DETECTOR
 	NetworkProperties prop1;
-	prop1.configFilePath = "../../../../deep-learning/estimators/age-estimator/resource/caffe/227x227/age_deploy.prototxt";
-	prop1.weightFilePath = "../../../../deep-learning/estimators/age-estimator/resource/caffe/227x227/age_net.caffemodel";
+	prop1.configFilePath = ModelRegistry::Resolve("deep-learning/estimators/age-estimator/resource/caffe/227x227/age_deploy.prototxt");
+	prop1.weightFilePath = ModelRegistry::Resolve("deep-learning/estimators/age-estimator/resource/caffe/227x227/age_net.caffemodel");
 	prop1.imageInputWidth = 227;
 	prop1.imageInputHeight = 227;
 	prop1.networkType = NetworkType::CAFFE;
@@ -58,7 +41,7 @@ AgeEstimator::InitializeNetworkPaths() {
 	m_networkPropertiesMap.insert(m_networkPropertiesMap.end(), pair1);
 	// ONNX_200x200 AGE DETECTOR
 	NetworkProperties prop2;
-	prop2.weightFilePath = "../../../../deep-learning/estimators/age-estimator/resource/onnx/200x200/AgePredictor.onnx";
+	prop2.weightFilePath = ModelRegistry::Resolve("deep-learning/estimators/age-estimator/resource/onnx/200x200/AgePredictor.onnx");
 	prop2.imageInputWidth = 200;
 	prop2.imageInputHeight = 200;
 	prop2.networkType = NetworkType::ONNX;
@@ -73,22 +56,26 @@ AgeEstimator::InitializeNetworkPaths() {
 	m_networkPropertiesMap.insert(m_networkPropertiesMap.end(), pair2);
 }
 
-std::string
-AgeEstimator::Estimate(const cv::Mat& face) {
-	auto frameWidth = face.size().width;
-	auto frameHeight = face.size().height;
-	auto ratioWidth = static_cast<double>(frameWidth) / static_cast<double>(m_networkProperties.imageInputWidth);
-	auto ratioHeight = static_cast<double>(frameHeight) / static_cast<double>(m_networkProperties.imageInputHeight);
-	auto ratio = ratioWidth < ratioHeight ? ratioWidth : ratioHeight;
-	cv::Mat resizedFace;
-	cv::resize(face, resizedFace, cv::Size(static_cast<int>(frameWidth / ratio), static_cast<int>(frameHeight / ratio)));
-	cv::Mat inputBlob = cv::dnn::blobFromImage(face, 1.0f, cv::Size(m_networkProperties.imageInputWidth, m_networkProperties.imageInputHeight),
-		m_networkProperties.meanValues, false);
-	m_network.setInput(inputBlob, m_inputName);
-	std::vector<float> agePreds = m_network.forward();
-	int maxIndiceAge = std::distance(agePreds.begin(), max_element(agePreds.begin(), agePreds.end()));
-	auto age = m_ageList[maxIndiceAge];
-	return age;
+AttributeEstimation
+AgeEstimator::Estimate(const cv::Mat& face, int topK) {
+	return EstimateBatch({ face }, topK).front();
+}
+
+std::vector<AttributeEstimation>
+AgeEstimator::EstimateBatch(const std::vector<cv::Mat>& faces, int topK) {
+	std::vector<AttributeEstimation> retVal;
+	if (faces.empty())
+		return retVal;
+	retVal.reserve(faces.size());
+	cv::Mat agePreds = m_network->Forward(faces).front();
+	for (int i = 0; i < agePreds.rows; ++i)
+		retVal.push_back(AttributeDecoder::Decode(agePreds.row(i), m_ageList, topK));
+	return retVal;
+}
+
+cv::Mat
+AgeEstimator::ForwardBlob(const cv::Mat& inputBlob) {
+	return m_network->ForwardBlob(inputBlob).front();
 }
 
 }
\ No newline at end of file
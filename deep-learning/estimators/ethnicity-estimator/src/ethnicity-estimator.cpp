@@ -5,6 +5,9 @@
 #include <opencv2/imgproc.hpp>
 #include <opencv2/highgui.hpp>
 
+#include <object-detection/attribute-decoder.h>
+#include <object-detection/model-registry.h>
+
 #include "ethnicity-estimator/ethnicity-estimator.h"
 
 std::shared_ptr<base::Logger> dl::EthnicityEstimator::m_logger = std::make_shared<base::Logger>();
@@ -20,24 +23,14 @@ EthnicityEstimator::EthnicityEstimator(EthnicityEstimatorType type, const std::s
 	if (m_networkProperties.expectedList.has_value())
 		m_ethnicityList = m_networkProperties.expectedList.value();
 
-	switch (m_networkProperties.networkType) {
-	case NetworkType::ONNX:
-	{
-		m_network = cv::dnn::readNetFromONNX(m_networkProperties.weightFilePath);
-		break;
-	}
-	default:
-	{
-		break;
-	}
-	}
+	m_network = std::make_unique<AttributeNetwork>(m_networkProperties, m_inputName);
 }
 
 void
 EthnicityEstimator::InitializeNetworkPaths() {
 	// ONNX_200x200 ETHNICITY DETECTOR
 	NetworkProperties prop1;
-	prop1.weightFilePath = "../../../../deep-learning/estimators/ethnicity-estimator/resource/onnx/200x200/EthnicityPredictor.onnx";
+	prop1.weightFilePath = ModelRegistry::Resolve("deep-learning/estimators/ethnicity-estimator/resource/onnx/200x200/EthnicityPredictor.onnx");
 	prop1.imageInputWidth = 200;
 	prop1.imageInputHeight = 200;
 	prop1.networkType = NetworkType::ONNX;
@@ -47,22 +40,26 @@ EthnicityEstimator::InitializeNetworkPaths() {
 	m_networkPropertiesMap.insert(m_networkPropertiesMap.end(), pair1);
 }
 
-std::string
-EthnicityEstimator::Estimate(const cv::Mat& face) {
-	auto frameWidth = face.size().width;
-	auto frameHeight = face.size().height;
-	auto ratioWidth = static_cast<double>(frameWidth) / static_cast<double>(m_networkProperties.imageInputWidth);
-	auto ratioHeight = static_cast<double>(frameHeight) / static_cast<double>(m_networkProperties.imageInputHeight);
-	auto ratio = ratioWidth < ratioHeight ? ratioWidth : ratioHeight;
-	cv::Mat resizedFace;
-	cv::resize(face, resizedFace, cv::Size(static_cast<int>(frameWidth / ratio), static_cast<int>(frameHeight / ratio)));
-	cv::Mat inputBlob = cv::dnn::blobFromImage(face, 1.0f, cv::Size(m_networkProperties.imageInputWidth, m_networkProperties.imageInputHeight),
-		m_networkProperties.meanValues, false);
-	m_network.setInput(inputBlob, m_inputName);
-	std::vector<float> ethnicityPreds = m_network.forward();
-	int maxIndiceEthnicity = std::distance(ethnicityPreds.begin(), max_element(ethnicityPreds.begin(), ethnicityPreds.end()));
-	auto ethnicity = m_ethnicityList[maxIndiceEthnicity];
-	return ethnicity;
+AttributeEstimation
+EthnicityEstimator::Estimate(const cv::Mat& face, int topK) {
+	return EstimateBatch({ face }, topK).front();
+}
+
+std::vector<AttributeEstimation>
+EthnicityEstimator::EstimateBatch(const std::vector<cv::Mat>& faces, int topK) {
+	std::vector<AttributeEstimation> retVal;
+	if (faces.empty())
+		return retVal;
+	retVal.reserve(faces.size());
+	cv::Mat ethnicityPreds = m_network->Forward(faces).front();
+	for (int i = 0; i < ethnicityPreds.rows; ++i)
+		retVal.push_back(AttributeDecoder::Decode(ethnicityPreds.row(i), m_ethnicityList, topK));
+	return retVal;
+}
+
+cv::Mat
+EthnicityEstimator::ForwardBlob(const cv::Mat& inputBlob) {
+	return m_network->ForwardBlob(inputBlob).front();
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <object-detection/object-detection.h>
+#include <age-estimator/age-estimator.h>
+#include <gender-estimator/gender-estimator.h>
+#include <ethnicity-estimator/ethnicity-estimator.h>
+#include <memory>
+#include <optional>
+
+namespace base {
+	class Logger;
+}
+
+namespace dl {
+
+struct AgeEstimatorProperties {
+	AgeEstimatorType type;
+	std::string inputName = "";
+	std::string outputName = "";
+};
+
+struct GenderEstimatorProperties {
+	GenderEstimatorType type;
+	std::string inputName = "";
+	std::string outputName = "";
+};
+
+struct EthnicityEstimatorProperties {
+	EthnicityEstimatorType type;
+	std::string inputName = "";
+	std::string outputName = "";
+};
+
+// one model with an output per attribute, attributes with an empty output name are not estimated
+struct MultiOutputAttributeModelProperties {
+	NetworkProperties networkProperties;
+	std::string inputName = "";
+	std::string ageOutputName = "";
+	std::string genderOutputName = "";
+	std::string ethnicityOutputName = "";
+	std::vector<std::string> ageList;
+	std::vector<std::string> genderList;
+	std::vector<std::string> ethnicityList;
+};
+
+struct FaceAttributes {
+	std::optional<AttributeEstimation> age;
+	std::optional<AttributeEstimation> gender;
+	std::optional<AttributeEstimation> ethnicity;
+};
+
+// estimates age, gender and ethnicity of face crops, the input blob is built once per batch and shared by every
+// network that takes the same input size and mean values, not thread safe
+class FaceAttributeEstimator {
+public:
+	FaceAttributeEstimator(std::optional<AgeEstimatorProperties> ageProp, std::optional<GenderEstimatorProperties> genderProp,
+		std::optional<EthnicityEstimatorProperties> ethnicityProp);
+	FaceAttributeEstimator(const MultiOutputAttributeModelProperties& properties);
+	~FaceAttributeEstimator() {}
+
+	FaceAttributes Estimate(const cv::Mat& face);
+	// results are in the order of the faces
+	std::vector<FaceAttributes> EstimateBatch(const std::vector<cv::Mat>& faces);
+
+	// number of best classes reported next to the argmax, at most AttributeEstimation::MAX_TOP_K
+	void SetTopK(int topK) { m_topK = topK; }
+
+	bool Empty() const { return !m_ageEstimator && !m_genderEstimator && !m_ethnicityEstimator && (!m_multiOutputNetwork || m_multiOutputNetwork->Empty()); }
+
+private:
+	void EstimateChunk(const std::vector<cv::Mat>& faces, std::vector<FaceAttributes>& retVal);
+	void EstimateMultiOutput(const std::vector<cv::Mat>& faces, std::vector<FaceAttributes>& retVal);
+	// makes sure the shared blob holds the faces prepared for the given network input
+	const cv::Mat& PrepareBlob(const std::vector<cv::Mat>& faces, const NetworkProperties& properties);
+
+	std::shared_ptr<AgeEstimator> m_ageEstimator;
+	std::shared_ptr<GenderEstimator> m_genderEstimator;
+	std::shared_ptr<EthnicityEstimator> m_ethnicityEstimator;
+	std::unique_ptr<AttributeNetwork> m_multiOutputNetwork;
+	MultiOutputAttributeModelProperties m_multiOutputProperties;
+	cv::Mat m_inputBlob;
+	cv::Size m_blobSize;
+	cv::Scalar m_blobMeanValues;
+	size_t m_maxBatchSize = 32;
+	int m_topK = 0;
+	static std::shared_ptr<base::Logger> m_logger;
+};
+
+}
@@ -0,0 +1,113 @@
+#include <logger/logger.h>
+#include <assertion/assertion.h>
+#include <opencv2/core.hpp>
+#include <algorithm>
+
+#include <object-detection/attribute-decoder.h>
+#include <object-detection/blob-builder.h>
+
+#include "face-attribute-estimator/face-attribute-estimator.h"
+
+std::shared_ptr<base::Logger> dl::FaceAttributeEstimator::m_logger = std::make_shared<base::Logger>();
+
+namespace dl {
+
+FaceAttributeEstimator::FaceAttributeEstimator(std::optional<AgeEstimatorProperties> ageProp, std::optional<GenderEstimatorProperties> genderProp,
+	std::optional<EthnicityEstimatorProperties> ethnicityProp) {
+	if (ageProp.has_value())
+		m_ageEstimator = std::make_shared<AgeEstimator>(ageProp.value().type, ageProp.value().inputName, ageProp.value().outputName);
+	if (genderProp.has_value())
+		m_genderEstimator = std::make_shared<GenderEstimator>(genderProp.value().type, genderProp.value().inputName, genderProp.value().outputName);
+	if (ethnicityProp.has_value())
+		m_ethnicityEstimator = std::make_shared<EthnicityEstimator>(ethnicityProp.value().type, ethnicityProp.value().inputName, ethnicityProp.value().outputName);
+}
+
+FaceAttributeEstimator::FaceAttributeEstimator(const MultiOutputAttributeModelProperties& properties)
+	: m_multiOutputProperties(properties) {
+	ASSERT((properties.networkProperties.networkType == NetworkType::ONNX), "Multi output attribute model must be an ONNX model", base::Logger::Severity::Error);
+	// outputs come back in the order of the names, absent attributes have no output
+	std::vector<std::string> outNames;
+	for (const auto& name : { properties.ageOutputName, properties.genderOutputName, properties.ethnicityOutputName }) {
+		if (!name.empty())
+			outNames.push_back(name);
+	}
+	m_multiOutputNetwork = std::make_unique<AttributeNetwork>(properties.networkProperties, properties.inputName, outNames);
+}
+
+FaceAttributes
+FaceAttributeEstimator::Estimate(const cv::Mat& face) {
+	return EstimateBatch({ face }).front();
+}
+
+std::vector<FaceAttributes>
+FaceAttributeEstimator::EstimateBatch(const std::vector<cv::Mat>& faces) {
+	std::vector<FaceAttributes> retVal;
+	retVal.reserve(faces.size());
+	if (m_multiOutputNetwork) {
+		EstimateMultiOutput(faces, retVal);
+		return retVal;
+	}
+	for (size_t first = 0; first < faces.size(); first += m_maxBatchSize) {
+		auto last = std::min(faces.size(), first + m_maxBatchSize);
+		EstimateChunk(std::vector<cv::Mat>(faces.begin() + first, faces.begin() + last), retVal);
+	}
+	return retVal;
+}
+
+void
+FaceAttributeEstimator::EstimateChunk(const std::vector<cv::Mat>& faces, std::vector<FaceAttributes>& retVal) {
+	// the blob is rebuilt only when a network needs a different input size or mean
+	m_blobSize = cv::Size();
+	auto offset = retVal.size();
+	retVal.resize(offset + faces.size());
+	if (m_ageEstimator) {
+		cv::Mat scores = m_ageEstimator->ForwardBlob(PrepareBlob(faces, m_ageEstimator->GetNetworkProperties()));
+		for (int i = 0; i < scores.rows; ++i)
+			retVal[offset + i].age = AttributeDecoder::Decode(scores.row(i), m_ageEstimator->GetLabels(), m_topK);
+	}
+	if (m_genderEstimator) {
+		cv::Mat scores = m_genderEstimator->ForwardBlob(PrepareBlob(faces, m_genderEstimator->GetNetworkProperties()));
+		for (int i = 0; i < scores.rows; ++i)
+			retVal[offset + i].gender = AttributeDecoder::Decode(scores.row(i), m_genderEstimator->GetLabels(), m_topK);
+	}
+	if (m_ethnicityEstimator) {
+		cv::Mat scores = m_ethnicityEstimator->ForwardBlob(PrepareBlob(faces, m_ethnicityEstimator->GetNetworkProperties()));
+		for (int i = 0; i < scores.rows; ++i)
+			retVal[offset + i].ethnicity = AttributeDecoder::Decode(scores.row(i), m_ethnicityEstimator->GetLabels(), m_topK);
+	}
+}
+
+void
+FaceAttributeEstimator::EstimateMultiOutput(const std::vector<cv::Mat>& faces, std::vector<FaceAttributes>& retVal) {
+	auto outs = m_multiOutputNetwork->Forward(faces);
+	auto offset = retVal.size();
+	retVal.resize(offset + faces.size());
+	size_t outIndex = 0;
+	if (!m_multiOutputProperties.ageOutputName.empty()) {
+		for (int i = 0; i < outs[outIndex].rows; ++i)
+			retVal[offset + i].age = AttributeDecoder::Decode(outs[outIndex].row(i), m_multiOutputProperties.ageList, m_topK);
+		++outIndex;
+	}
+	if (!m_multiOutputProperties.genderOutputName.empty()) {
+		for (int i = 0; i < outs[outIndex].rows; ++i)
+			retVal[offset + i].gender = AttributeDecoder::Decode(outs[outIndex].row(i), m_multiOutputProperties.genderList, m_topK);
+		++outIndex;
+	}
+	if (!m_multiOutputProperties.ethnicityOutputName.empty()) {
+		for (int i = 0; i < outs[outIndex].rows; ++i)
+			retVal[offset + i].ethnicity = AttributeDecoder::Decode(outs[outIndex].row(i), m_multiOutputProperties.ethnicityList, m_topK);
+	}
+}
+
+const cv::Mat&
+FaceAttributeEstimator::PrepareBlob(const std::vector<cv::Mat>& faces, const NetworkProperties& properties) {
+	cv::Size size(properties.imageInputWidth, properties.imageInputHeight);
+	if (size != m_blobSize || properties.meanValues != m_blobMeanValues) {
+		BlobBuilder::CreateBlob(faces, size, 1.0, properties.meanValues, false, m_inputBlob);
+		m_blobSize = size;
+		m_blobMeanValues = properties.meanValues;
+	}
+	return m_inputBlob;
+}
+
+}
\ No newline at end of file
@@ -1,11 +1,10 @@
 #pragma once
 
 #include <object-detection/object-detection.h>
-#include <age-estimator/age-estimator.h>
-#include <gender-estimator/gender-estimator.h>
-#include <ethnicity-estimator/ethnicity-estimator.h>
+#include <face-attribute-estimator/face-attribute-estimator.h>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 
 namespace base {
@@ -21,38 +20,22 @@ enum class FaceDetectorType {
 	CAFFE_227x227_GENDER = 4
 };
 
-struct AgeEstimatorProperties {
-	AgeEstimatorType type;
-	std::string inputName = "";
-	std::string outputName = "";
-};
-
-struct GenderEstimatorProperties {
-	GenderEstimatorType type;
-	std::string inputName = "";
-	std::string outputName = "";
-};
-
-struct EthnicityEstimatorProperties {
-	EthnicityEstimatorType type;
-	std::string inputName = "";
-	std::string outputName = "";
-};
-
 class FaceDetector : public BaseDetector {
 public:
 	FaceDetector(FaceDetectorType type, std::optional<AgeEstimatorProperties> ageProp, 
 		std::optional<GenderEstimatorProperties> genderProp, std::optional<EthnicityEstimatorProperties> ethnicityProp);
 	~FaceDetector() {}
 	void InitializeNetworkPaths() override;
-	DetectionResult Detect(const cv::Mat& frame, std::optional<Object> oneClassNetwork, bool oneFace = false) override;
+	void EstimateAttributes(DetectionContext& context) override;
+	// replaces the estimator built from the constructor arguments, e.g. with a multi output model
+	void SetFaceAttributeEstimator(std::shared_ptr<FaceAttributeEstimator> estimator) { m_attributeEstimator = estimator; }
 
 private:
 	FaceDetectorType m_faceDetectorType;
 	std::map<FaceDetectorType, NetworkProperties> m_networkPropertiesMap;
-	std::optional<std::shared_ptr<AgeEstimator>> m_ageEstimator;
-	std::optional<std::shared_ptr<GenderEstimator>> m_genderEstimator;
-	std::optional<std::shared_ptr<EthnicityEstimator>> m_ethnicityEstimator;
+	std::shared_ptr<FaceAttributeEstimator> m_attributeEstimator;
+	// the estimator owns a single network per attribute, concurrent detections take turns
+	std::mutex m_estimatorMutex;
 	static std::shared_ptr<base::Logger> m_logger;
 };
 
@@ -7,6 +7,7 @@ int main(int argc, char** argv) {
 	cxxopts::Options options("Feature Detector");
 	options.add_options()
 		("image", "Image path", cxxopts::value<std::string>()->default_value("../../../../deep-learning/face-detection/resource/1.jpg"))
+		("tiled", "Detect on overlapping tiles to find small faces in large images", cxxopts::value<bool>()->default_value("false"))
 		("h,help", "Print usage");
 
 	auto result = options.parse(argc, argv);
@@ -41,6 +42,9 @@ int main(int argc, char** argv) {
 
 	auto detector = std::make_shared<dl::FaceDetector>(dl::FaceDetectorType::CAFFE_300x300, ageProp, genderProp, ethnicityProp);
 	dl::DetectionParameters params;
+	params.renderMode = dl::RenderMode::BOXES;
+	params.tilingParameters.enabled = result["tiled"].as<bool>();
+	params.nmsParameters.mode = params.tilingParameters.enabled ? dl::NmsMode::HARD : dl::NmsMode::NONE;
 
 	detector->SetDetectionParameters(params);
 	auto detectionResults = detector->Detect(image, dl::Object::FACE);
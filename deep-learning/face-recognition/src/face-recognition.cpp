@@ -5,6 +5,8 @@
 #include <opencv2/imgproc.hpp>
 #include <opencv2/highgui.hpp>
 
+#include <object-detection/model-registry.h>
+
 #include "face-recognition/face-recognition.h"
 
 std::shared_ptr<base::Logger> dl::FaceRecognizer::m_logger = std::make_shared<base::Logger>();
@@ -66,7 +68,7 @@ FaceRecognizer::Predict(cv::Mat warpedFaceImage, std::optional<std::string> expe
 void
 FaceRecognizer::LoadFaceDatabase() {
 	m_faceDatabase.clear();
-	auto directories = base::File::GetDirectories("../../../../deep-learning/face-recognition/resource");
+	auto directories = base::File::GetDirectories(ModelRegistry::Resolve("deep-learning/face-recognition/resource"));
 	std::vector<std::string> names;
 	for (auto& dir : directories) {
 		dir = base::String::ReplaceAll(dir, "\\", "/");
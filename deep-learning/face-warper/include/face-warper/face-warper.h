@@ -28,10 +28,8 @@ struct WarpingResult {
 
 class FaceWarper {
 public:
-	FaceWarper() { 
-		m_facemark = cv::face::FacemarkLBF::create(); 
-		m_facemark->loadModel("../../../../deep-learning/face-warper/resource/lbfmodel.yaml");
-	}
+	// the LBF model is loaded through its binary cache, see dl::LandmarkModelCache
+	FaceWarper();
 	~FaceWarper() {}
 
 	void DrawPolyline(cv::Mat& im, const std::vector<cv::Point2f>& landmarks, const int start, const int end, bool isClosed = false);
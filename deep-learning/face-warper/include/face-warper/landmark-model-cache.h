@@ -0,0 +1,29 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <opencv2/face.hpp>
+#include <memory>
+#include <string>
+
+namespace base {
+	class Logger;
+}
+
+namespace dl {
+
+// LBF landmark models are large YAML files of numbers in plain text, parsing them dominates the start up of every
+// tool using the FaceWarper, the cache is the same model with all numeric sequences and matrices stored base64
+// packed next to the YAML, which FileStorage reads back without parsing text numbers
+class LandmarkModelCache {
+public:
+	// loads the cache of the model, the cache is written first when it is missing or older than the model
+	static void Load(const cv::Ptr<cv::face::Facemark>& facemark, const std::string& modelPath);
+	static std::string GetCachePath(const std::string& modelPath);
+	static bool WriteCache(const std::string& modelPath, const std::string& cachePath);
+
+private:
+	static void CopyNode(const cv::FileNode& node, const std::string& name, cv::FileStorage& fs);
+	static std::shared_ptr<base::Logger> m_logger;
+};
+
+}
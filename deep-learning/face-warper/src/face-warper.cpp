@@ -5,7 +5,10 @@
 #include <opencv2/imgproc.hpp>
 #include <opencv2/highgui.hpp>
 
+#include <object-detection/model-registry.h>
+
 #include "face-warper/face-warper.h"
+#include "face-warper/landmark-model-cache.h"
 #include "face-warper/reference.h"
 
 std::shared_ptr<base::Logger> dl::FaceWarper::m_logger = std::make_shared<base::Logger>();
@@ -14,6 +17,11 @@ std::shared_ptr<base::Logger> dl::FaceWarper::m_logger = std::make_shared<base::
 
 namespace dl {
 
+FaceWarper::FaceWarper() {
+	m_facemark = cv::face::FacemarkLBF::create();
+	LandmarkModelCache::Load(m_facemark, ModelRegistry::Resolve("deep-learning/face-warper/resource/lbfmodel.yaml"));
+}
+
 void
 FaceWarper::DrawPolyline(cv::Mat& im, const std::vector<cv::Point2f>& landmarks, const int start, const int end, bool isClosed) {
 	std::vector<cv::Point> points;
@@ -0,0 +1,128 @@
+#include <logger/logger.h>
+#include <opencv2/core.hpp>
+#include <filesystem>
+
+#include "face-warper/landmark-model-cache.h"
+
+std::shared_ptr<base::Logger> dl::LandmarkModelCache::m_logger = std::make_shared<base::Logger>();
+
+namespace dl {
+
+void
+LandmarkModelCache::Load(const cv::Ptr<cv::face::Facemark>& facemark, const std::string& modelPath) {
+	auto cachePath = GetCachePath(modelPath);
+	std::error_code error;
+	bool cacheValid = std::filesystem::exists(cachePath, error) &&
+		std::filesystem::last_write_time(cachePath, error) >= std::filesystem::last_write_time(modelPath, error) && !error;
+
+	cv::TickMeter timer;
+	if (!cacheValid) {
+		timer.start();
+		cacheValid = WriteCache(modelPath, cachePath);
+		timer.stop();
+		std::string logMsg = cacheValid ? "Landmark model cache " + cachePath + " written in " + std::to_string(timer.getTimeMilli()) + " ms" :
+			"Landmark model cache " + cachePath + " can not be written, loading " + modelPath;
+		m_logger->LogInfo(logMsg.c_str());
+		timer.reset();
+	}
+
+	timer.start();
+	facemark->loadModel(cacheValid ? cachePath : modelPath);
+	timer.stop();
+	std::string logMsg = "Landmark model loaded from " + (cacheValid ? cachePath : modelPath) + " in " + std::to_string(timer.getTimeMilli()) + " ms";
+	m_logger->LogInfo(logMsg.c_str());
+}
+
+std::string
+LandmarkModelCache::GetCachePath(const std::string& modelPath) {
+	std::filesystem::path path(modelPath);
+	path.replace_extension(".cache.yml");
+	return path.string();
+}
+
+bool
+LandmarkModelCache::WriteCache(const std::string& modelPath, const std::string& cachePath) {
+	cv::FileStorage model(modelPath, cv::FileStorage::READ);
+	if (!model.isOpened())
+		return false;
+	// written to a temporary file first so that an interrupted run never leaves a broken cache behind
+	auto temporaryPath = cachePath + ".tmp";
+	{
+		cv::FileStorage cache(temporaryPath, cv::FileStorage::WRITE_BASE64);
+		if (!cache.isOpened())
+			return false;
+		for (const auto& node : model.root())
+			CopyNode(node, node.name(), cache);
+	}
+	std::error_code error;
+	std::filesystem::rename(temporaryPath, cachePath, error);
+	if (error) {
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+	return true;
+}
+
+void
+LandmarkModelCache::CopyNode(const cv::FileNode& node, const std::string& name, cv::FileStorage& fs) {
+	// elements of a sequence have no name
+	auto WriteName = [&name, &fs]() {
+		if (!name.empty())
+			fs << name;
+	};
+
+	if (node.isMap()) {
+		if (!node["rows"].empty() && !node["cols"].empty() && !node["dt"].empty() && !node["data"].empty()) {
+			cv::Mat matrix;
+			node >> matrix;
+			WriteName();
+			fs << matrix;
+			return;
+		}
+		WriteName();
+		fs << "{";
+		for (const auto& child : node)
+			CopyNode(child, child.name(), fs);
+		fs << "}";
+	}
+	else if (node.isSeq()) {
+		bool allInt = true;
+		bool allNumber = true;
+		for (const auto& child : node) {
+			allInt = allInt && child.isInt();
+			allNumber = allNumber && (child.isInt() || child.isReal());
+		}
+		WriteName();
+		// plain numeric sequences are the bulk of the model and go out as one base64 block
+		if (allInt && node.size() > 0) {
+			std::vector<int> values;
+			node >> values;
+			fs << values;
+		}
+		else if (allNumber && node.size() > 0) {
+			std::vector<double> values;
+			node >> values;
+			fs << values;
+		}
+		else {
+			fs << "[";
+			for (const auto& child : node)
+				CopyNode(child, std::string(), fs);
+			fs << "]";
+		}
+	}
+	else if (node.isInt()) {
+		WriteName();
+		fs << static_cast<int>(node);
+	}
+	else if (node.isReal()) {
+		WriteName();
+		fs << static_cast<double>(node);
+	}
+	else if (node.isString()) {
+		WriteName();
+		fs << static_cast<std::string>(node);
+	}
+}
+
+}
@@ -22,7 +22,9 @@ public:
 	InstanceSegmentator(InstanceSegmentationType type);
 	~InstanceSegmentator() {}
 	void InitializeNetworkPaths() override;
-	DetectionResult Detect(const cv::Mat& frame, std::optional<Object> oneClassNetwork, bool oneObject = false) override;
+
+protected:
+	void PostprocessDetections(DetectionContext& context) const override;
 
 private:
 	std::vector<cv::Scalar> m_colors;
@@ -36,6 +36,7 @@ int main(int argc, char** argv) {
 	cv::Mat image = cv::imread(imagePath.c_str());
 	auto segmentator = std::make_shared<dl::InstanceSegmentator>(dl::InstanceSegmentationType::TENSORFLOW_MASK_RCNN);
 	dl::DetectionParameters params;
+	params.renderMode = dl::RenderMode::BOXES_MASKS_AND_CONTOURS;
 	params.inputName = "";
 	params.meanValues = { 0.0, 0.0, 0.0 };
 	params.outputDetectionName = "detection_out_final";
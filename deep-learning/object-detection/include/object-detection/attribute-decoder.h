@@ -0,0 +1,14 @@
+#pragma once
+
+#include <object-detection/object-detection.h>
+
+namespace dl {
+
+class AttributeDecoder {
+public:
+	// argmax, probability and top-k of one row of class scores without allocating, scores that are not already
+	// a distribution are normalized with softmax, topK is limited to AttributeEstimation::MAX_TOP_K
+	static AttributeEstimation Decode(const cv::Mat& scores, const std::vector<std::string>& labels, int topK = 0);
+};
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <object-detection/object-detection.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace base {
+	class Logger;
+}
+
+namespace dl {
+
+// classification network over face crops, the crops are stacked into one blob per chunk of at most maxBatchSize faces
+// and models exported with a fixed batch size of one are run crop by crop instead, not thread safe
+class AttributeNetwork {
+public:
+	// an empty output name list forwards the default output of the network
+	AttributeNetwork(const NetworkProperties& properties, const std::string& inputName, const std::vector<std::string>& outputNames = {});
+	~AttributeNetwork() {}
+
+	// scores per output with one row per face, in the order of the faces
+	std::vector<cv::Mat> Forward(const std::vector<cv::Mat>& faces);
+	// scores per output of an already built NCHW blob, one row per image of the blob
+	std::vector<cv::Mat> ForwardBlob(const cv::Mat& inputBlob);
+
+	void SetMaxBatchSize(size_t maxBatchSize) { m_maxBatchSize = std::max<size_t>(1, maxBatchSize); }
+	const NetworkProperties& GetNetworkProperties() const { return m_networkProperties; }
+	bool Empty() const { return m_network.empty(); }
+
+private:
+	std::vector<cv::Mat> ForwardStacked(const cv::Mat& inputBlob);
+
+	cv::dnn::Net m_network;
+	NetworkProperties m_networkProperties;
+	std::string m_inputName;
+	std::vector<std::string> m_outputNames;
+	cv::Mat m_inputBlob;
+	size_t m_maxBatchSize = 32;
+	bool m_batchSupported = true;
+	static std::shared_ptr<base::Logger> m_logger;
+};
+
+}
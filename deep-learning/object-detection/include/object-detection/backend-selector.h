@@ -0,0 +1,39 @@
+#pragma once
+
+#include <object-detection/object-detection.h>
+#include <mutex>
+#include <optional>
+
+namespace base {
+	class Logger;
+}
+
+namespace dl {
+
+class BackendSelector {
+public:
+	// sets the backend and target of the network according to the policy, the choice for AUTO is cached per model file
+	static BackendChoice Apply(cv::dnn::Net& network, const NetworkProperties& properties);
+	// the targets of the policy converted to the precision, e.g. CUDA becomes CUDA_FP16 for FP16
+	static std::vector<BackendChoice> GetCandidates(BackendPolicy policy, Precision precision = Precision::FP32);
+	static BackendChoice ApplyPrecision(const BackendChoice& choice, Precision precision);
+	static std::string ConvertPrecisionToString(Precision precision);
+	static std::string ConvertBackendChoiceToString(const BackendChoice& choice);
+
+	static void SetCachePath(const std::string& cachePath) { m_cachePath = cachePath; }
+	static void SetWarmupIterations(int iterations) { m_warmupIterations = iterations; }
+
+private:
+	static std::vector<BackendChoice> GetPolicyCandidates(BackendPolicy policy);
+	static std::optional<double> Benchmark(cv::dnn::Net& network, const BackendChoice& choice, const cv::Mat& inputBlob);
+	static std::string CreateCacheKey(const NetworkProperties& properties);
+	static std::optional<BackendChoice> ReadCache(const std::string& key);
+	static void WriteCache(const std::string& key, const BackendChoice& choice);
+
+	static std::string m_cachePath;
+	static int m_warmupIterations;
+	static std::mutex m_cacheMutex;
+	static std::shared_ptr<base::Logger> m_logger;
+};
+
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+namespace dl {
+
+// builds NCHW float input blobs like cv::dnn::blobFromImages, but resizes, swaps channels, subtracts the mean,
+// scales and transposes in a single pass without intermediate images
+class BlobBuilder {
+public:
+	// every image is resized to size, blob is only reallocated when its shape changes
+	static void CreateBlob(const std::vector<cv::Mat>& images, cv::Size size, double scaleFactor, const cv::Scalar& meanValues,
+		bool swapRB, cv::Mat& blob);
+	// header of the single image blob at index, shares the data of blob
+	static cv::Mat SliceBlob(const cv::Mat& blob, int index);
+
+private:
+	// writes one 8-bit 3 channel image into the 3 planes starting at blobData
+	static void FillBlob(const cv::Mat& image, cv::Size size, double scaleFactor, const cv::Scalar& meanValues, bool swapRB, float* blobData);
+};
+
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <object-detection/object-detection.h>
+
+namespace dl {
+
+class DetectionRenderer {
+public:
+	// fills imageWithBbox (and imageWithBboxAndMasks when masks are rendered) from the original image of the result
+	static void Render(DetectionResult& result, RenderMode mode);
+	static void DrawDetection(cv::Mat& image, const Detection& detection);
+	// blends the mask into image in place, contours are only traced when requested
+	static void DrawMask(cv::Mat& image, const SegmentationDrawingElement& element, bool contours = false);
+};
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <object-detection/object-detection.h>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace base {
+	class Logger;
+}
+
+namespace dl {
+
+// hands out independent detectors of the same model to concurrent callers, model files come from the ModelRegistry
+// and further networks are created lazily up to the maximum size when every existing one is in use
+// pooled detectors only run forward passes with the names of the caller's own detector (Detector::Forward), they
+// carry no detection parameters
+class DetectorPool : public std::enable_shared_from_this<DetectorPool> {
+public:
+	// returns its detector to the pool when destroyed
+	class Lease {
+	public:
+		Lease(std::shared_ptr<DetectorPool> pool, std::shared_ptr<Detector> detector)
+			: m_pool(pool), m_detector(detector) {}
+		Lease(Lease&& other) = default;
+		Lease& operator=(Lease&& other) = default;
+		Lease(const Lease&) = delete;
+		Lease& operator=(const Lease&) = delete;
+		~Lease() {
+			if (m_pool && m_detector)
+				m_pool->Release(m_detector);
+		}
+
+		Detector* operator->() const { return m_detector.get(); }
+		Detector& operator*() const { return *m_detector; }
+
+	private:
+		std::shared_ptr<DetectorPool> m_pool;
+		std::shared_ptr<Detector> m_detector;
+	};
+
+	// maxSize 0 uses the number of hardware threads
+	DetectorPool(const NetworkProperties& properties, size_t maxSize = 0);
+	~DetectorPool() {}
+
+	// blocks until a detector is free when the pool is already at its maximum size
+	Lease Acquire();
+	void SetMaxSize(size_t maxSize);
+
+	// first detector of the pool, its const members can be used from any thread
+	std::shared_ptr<Detector> GetPrototype() const { return m_prototype; }
+	size_t GetSize() const;
+	size_t GetMaxSize() const;
+
+private:
+	void Release(std::shared_ptr<Detector> detector);
+
+	NetworkProperties m_networkProperties;
+	std::shared_ptr<const ModelBuffer> m_model;
+	std::shared_ptr<Detector> m_prototype;
+	std::vector<std::shared_ptr<Detector>> m_detectors;
+	std::vector<std::shared_ptr<Detector>> m_idleDetectors;
+	size_t m_maxSize = 1;
+	size_t m_pendingDetectors = 0;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_detectorReleased;
+	static std::shared_ptr<base::Logger> m_logger;
+};
+
+}
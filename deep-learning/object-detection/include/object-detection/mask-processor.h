@@ -0,0 +1,22 @@
+#pragma once
+
+#include <object-detection/rle-mask.h>
+#include <opencv2/opencv.hpp>
+
+namespace dl {
+
+// turns the low resolution float masks of instance segmentation networks into bbox sized binary masks and paints
+// them onto frames, every step only touches the pixels of the bbox and needs no intermediate full size images
+class MaskProcessor {
+public:
+	// bilinearly samples lowResMask at size and thresholds it in a single pass, mask is CV_8U with 255 inside
+	static void Binarize(const cv::Mat& lowResMask, cv::Size size, float threshold, cv::Mat& mask);
+	// blends color into the 8-bit image in place under the non-zero pixels of mask placed at bbox
+	static void Blend(cv::Mat& image, const cv::Rect& bbox, const cv::Mat& mask, const cv::Scalar& color, float alpha = 0.3f);
+	// same for an encoded mask, walks the foreground runs without decoding them
+	static void Blend(cv::Mat& image, const RleMask& mask, const cv::Scalar& color, float alpha = 0.3f);
+	// outlines the mask placed at bbox, contours are only traced when this is called
+	static void DrawContours(cv::Mat& image, const cv::Rect& bbox, const cv::Mat& mask, const cv::Scalar& color, int thickness = 5);
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <object-detection/object-detection.h>
+#include <map>
+#include <mutex>
+#include <optional>
+
+namespace base {
+	class Logger;
+}
+
+namespace dl {
+
+// mapping only reserves address space, the weights are read when the networks are parsed and every network keeps its
+// own copy of them, so the memory of a model grows with networkCount rather than with mappedBytes
+struct ModelStatistics {
+	std::string weightFilePath;
+	size_t mappedBytes = 0;
+	double mapTimeMs = 0.0;
+	size_t networkCount = 0;
+	double parseTimeMs = 0.0;
+	// every request would have read the files again without the registry
+	size_t requestCount = 0;
+	bool resident = false;
+};
+
+// process wide cache of model files, detectors and estimators ask for their model by resource path and the
+// files are only mapped when a model is used first, identical files are mapped once for the whole process and
+// identical detectors share one DetectorPool
+class DetectorPool;
+
+class ModelRegistry {
+public:
+	// resource paths are relative to the root, which defaults to the repository root as seen from the build output
+	static void SetRoot(const std::string& root);
+	static std::string GetRoot();
+	// YAML/JSON manifest with an optional "root" and a "models" sequence of { resource, path } entries that move
+	// single resources somewhere else, e.g. models: [ { resource: "deep-learning/...", path: "/opt/models/x.onnx" } ]
+	static bool LoadManifest(const std::string& manifestPath);
+	static std::string Resolve(const std::string& resourcePath);
+
+	// properties of the model that is actually loaded for the precision, INT8 switches to the quantized ONNX export
+	static NetworkProperties ResolvePrecision(const NetworkProperties& properties);
+	// maps the model files on first use and shares them afterwards, nullptr when a file can not be mapped, the next
+	// request tries again
+	static std::shared_ptr<const ModelBuffer> GetModel(const NetworkProperties& properties);
+	// new network from the shared model files, without backend selection, the first overload resolves the precision
+	static cv::dnn::Net CreateNetwork(const NetworkProperties& properties);
+	static cv::dnn::Net CreateNetwork(const NetworkProperties& properties, const ModelBuffer& model);
+	// one pool per model, input size, precision and backend policy, detectors of the same model share its networks
+	// for as long as one of them holds the pool
+	static std::shared_ptr<DetectorPool> GetDetectorPool(const NetworkProperties& properties);
+
+	// unmaps the files no detector holds anymore, networks already created keep working
+	static void ReleaseUnused();
+	static std::vector<ModelStatistics> GetStatistics();
+	static void LogStatistics();
+
+private:
+	struct Entry {
+		std::shared_ptr<const ModelBuffer> model;
+		ModelStatistics statistics;
+	};
+
+	static std::string CreateKey(const NetworkProperties& properties);
+
+	static std::string m_root;
+	static std::map<std::string, std::string> m_overrides;
+	static std::map<std::string, Entry> m_models;
+	static std::map<std::string, std::weak_ptr<DetectorPool>> m_pools;
+	static std::mutex m_mutex;
+	// separate from m_mutex, creating a pool parses the first network and asks for the model files
+	static std::mutex m_poolMutex;
+	static std::shared_ptr<base::Logger> m_logger;
+};
+
+}
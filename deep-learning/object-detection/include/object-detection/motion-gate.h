@@ -0,0 +1,72 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <vector>
+
+namespace base {
+	class Logger;
+}
+
+namespace dl {
+
+// frames are compared with a running background at 1/downscale of their size, cells whose gray value differs by more
+// than pixelThreshold count as changed and backgroundRate sets how fast the background follows the frames
+// frames with less than minChangedFraction changed cells are skipped, otherwise the changed cells are grouped into
+// regions grown by margin frame pixels, regions covering more than maxRegionFraction of the frame fall back to the
+// whole frame, boxes of neighbouring regions are merged like the boxes of tiles with mergeThreshold
+struct MotionGatingParameters {
+	bool enabled = false;
+	int downscale = 8;
+	float pixelThreshold = 20.0f;
+	float backgroundRate = 0.5f;
+	float minChangedFraction = 0.002f;
+	int margin = 32;
+	float maxRegionFraction = 0.5f;
+	float mergeThreshold = 0.6f;
+};
+
+struct MotionStatistics {
+	size_t frames = 0;
+	size_t skippedFrames = 0;
+	size_t pixels = 0;
+	size_t skippedPixels = 0;
+
+	double SkippedFrameFraction() const { return frames ? static_cast<double>(skippedFrames) / frames : 0.0; }
+	double SkippedPixelFraction() const { return pixels ? static_cast<double>(skippedPixels) / pixels : 0.0; }
+};
+
+// cheap change detection in front of a detector, keeps the background of a single stream so frames must be pushed
+// in order and from one thread at a time
+class MotionGate {
+public:
+	MotionGate() = default;
+
+	void SetParameters(const MotionGatingParameters& params);
+	const MotionGatingParameters& GetParameters() const { return m_params; }
+
+	// compares frame with the background and updates it, returns false when the frame can be skipped, otherwise
+	// regions are the disjoint changed areas in frame coordinates, a single region of the whole frame when everything
+	// has to be detected (e.g. the first frame)
+	bool Update(const cv::Mat& frame, std::vector<cv::Rect>& regions);
+	// forgets the background, the next frame is detected completely
+	void Reset();
+
+	const MotionStatistics& GetStatistics() const { return m_statistics; }
+	void LogStatistics() const;
+
+private:
+	// joins intersecting regions until all of them are disjoint
+	static void MergeRegions(std::vector<cv::Rect>& regions);
+
+	MotionGatingParameters m_params;
+	MotionStatistics m_statistics;
+	cv::Mat m_background;
+	cv::Mat m_small;
+	cv::Mat m_gray;
+	cv::Mat m_difference;
+	cv::Mat m_changed;
+	static std::shared_ptr<base::Logger> m_logger;
+};
+
+}
\ No newline at end of file
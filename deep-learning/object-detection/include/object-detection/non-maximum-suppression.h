@@ -0,0 +1,26 @@
+#pragma once
+
+#include <object-detection/object-detection.h>
+
+namespace dl {
+
+class NonMaximumSuppression {
+public:
+	// suppresses overlapping detections in place, the survivors are ordered by descending confidence
+	// soft modes lower the confidence of overlapping boxes instead and drop them below scoreThreshold
+	static void Apply(std::vector<Detection>& detections, const NmsParameters& params, float scoreThreshold = 0.0f);
+
+	// merges boxes whose intersection covers more than threshold of the smaller one into the union of both, e.g. the
+	// halves of an object cut by a tile border, the merged box keeps the highest confidence
+	static void Merge(std::vector<Detection>& detections, float threshold, bool perClass = true);
+
+	static float IntersectionOverUnion(const cv::Rect& a, const cv::Rect& b);
+
+private:
+	static void ApplyHard(const std::vector<Detection>& detections, const std::vector<int>& order, size_t begin, size_t end,
+		const NmsParameters& params, std::vector<int>& kept);
+	static void ApplySoft(std::vector<Detection>& detections, const std::vector<int>& order, size_t begin, size_t end,
+		const NmsParameters& params, float scoreThreshold, std::vector<int>& kept);
+};
+
+}
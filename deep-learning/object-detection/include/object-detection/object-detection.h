@@ -3,10 +3,15 @@
 #include <opencv2/opencv.hpp>
 #include <opencv2/dnn.hpp>
 #include <opencv2/dnn/dnn.hpp>
+#include <object-detection/rle-mask.h>
+#include <object-detection/motion-gate.h>
+#include <array>
 #include <optional>
+#include <string_view>
 
 namespace base {
 	class Logger;
+	class MappedFile;
 }
 
 namespace dl {
@@ -102,11 +107,46 @@ enum class NetworkType {
 	ONNX = 3
 };
 
-// structs for drawing instance segmentation
+// preferred backend/target combination of a network, AUTO benchmarks every available combination and picks the fastest
+enum class BackendPolicy {
+	AUTO = 1,
+	OPENCV_CPU = 2,
+	OPENCV_OPENCL = 3,
+	OPENCV_OPENCL_FP16 = 4,
+	INFERENCE_ENGINE_CPU = 5,
+	INFERENCE_ENGINE_OPENCL_FP16 = 6,
+	INFERENCE_ENGINE_MYRIAD = 7,
+	CUDA = 8,
+	CUDA_FP16 = 9
+};
+
+// arithmetic precision of a network, FP16 selects the half precision variant of the target (CPU keeps FP32 arithmetic),
+// INT8 runs a quantized ONNX model on the OpenCV CPU backend
+enum class Precision {
+	FP32 = 1,
+	FP16 = 2,
+	INT8 = 3
+};
+
+// structs for drawing instance segmentation, networkMask is the raw low resolution output and shares the output
+// blob of the network, postprocessing encodes it into mask and releases it
 struct SegmentationDrawingElement {
-	cv::Mat coloredRoi;
 	cv::Rect bbox;
-	cv::Mat mask;
+	cv::Mat networkMask;
+	RleMask mask;
+	cv::Scalar color;
+};
+
+// result of an attribute estimator, label points into the label table of the estimator and stays valid as long
+// as the estimator lives, the first topCount entries of the top lists are filled when top-k was requested
+struct AttributeEstimation {
+	static constexpr int MAX_TOP_K = 5;
+	int classId = -1;
+	float probability = 0.0f;
+	std::string_view label;
+	int topCount = 0;
+	std::array<int, MAX_TOP_K> topClassIds = {};
+	std::array<float, MAX_TOP_K> topProbabilities = {};
 };
 
 struct Detection {
@@ -115,12 +155,13 @@ struct Detection {
 	int classId;
 	std::optional<Object> objectClass;
 	std::optional<std::string> objectClassString;
-	std::optional<std::string> ageEstimation;
-	std::optional<std::string> genderEstimation;
-	std::optional<std::string> ethnicityEstimation;
+	std::optional<AttributeEstimation> ageEstimation;
+	std::optional<AttributeEstimation> genderEstimation;
+	std::optional<AttributeEstimation> ethnicityEstimation;
 	std::optional<SegmentationDrawingElement> drawingElement;
 };
 
+// originalImage shares the buffer of the input frame, rendered images are empty unless rendering is requested
 struct DetectionResult {
 	std::vector<Detection> detections;
 	cv::Mat originalImage;
@@ -138,6 +179,22 @@ struct NetworkProperties {
 	NetworkType networkType;
 	std::optional<std::vector<std::string>> expectedList;
 	cv::Scalar meanValues = cv::Scalar(0, 0, 0);
+	BackendPolicy backendPolicy = BackendPolicy::AUTO;
+	Precision precision = Precision::FP32;
+	// quantized ONNX export of the model, replaces the model files when precision is INT8
+	std::string int8WeightFilePath = "";
+};
+
+// memory mapped model files shared by every network created from them, configFile is empty for single file models
+struct ModelBuffer {
+	std::shared_ptr<const base::MappedFile> configFile;
+	std::shared_ptr<const base::MappedFile> weightFile;
+};
+
+struct BackendChoice {
+	cv::dnn::Backend backend = cv::dnn::DNN_BACKEND_OPENCV;
+	cv::dnn::Target target = cv::dnn::DNN_TARGET_CPU;
+	double inferenceTimeMs = 0.0;
 };
 
 enum class DetectionFeature {
@@ -147,16 +204,70 @@ enum class DetectionFeature {
 	BBOX_RIGHT = 4,
 	BBOX_BOTTOM = 5,
 	CLASS_ID = 6,
+	IMAGE_ID = 7
+};
+
+enum class RenderMode {
+	NONE = 1,
+	BOXES = 2,
+	BOXES_AND_MASKS = 3,
+	BOXES_MASKS_AND_CONTOURS = 4
+};
+
+// layout of the detection output, SSD is the [1, 1, N, 7] detection_out tensor described by detectionFeatureMap,
+// YOLO are [N, 5 + C] grids of (cx, cy, w, h, objectness, class scores) rows which need NMS afterwards
+enum class OutputLayout {
+	SSD = 1,
+	YOLO = 2
+};
+
+enum class NmsMode {
+	NONE = 1,
+	HARD = 2,
+	SOFT_LINEAR = 3,
+	SOFT_GAUSSIAN = 4
+};
+
+// perClass only lets boxes of the same class suppress each other, topK caps the number of boxes per frame (0 keeps all)
+// sigma is only used by SOFT_GAUSSIAN
+struct NmsParameters {
+	NmsMode mode = NmsMode::NONE;
+	float iouThreshold = 0.45f;
+	int topK = 0;
+	bool perClass = true;
+	float sigma = 0.5f;
+};
+
+// frames are cut into overlapping tiles of tileSize frame pixels (an empty size uses twice the network input) that are
+// detected in batches of maxTilesPerBatch next to one full frame pass, boxes of neighbouring tiles are merged when
+// the overlap over the smaller box exceeds mergeThreshold
+// with coarseGating only tiles around the boxes the full frame pass finds above coarseConfidenceThreshold are detected
+struct TilingParameters {
+	bool enabled = false;
+	cv::Size tileSize;
+	float overlap = 0.2f;
+	int maxTilesPerBatch = 8;
+	float mergeThreshold = 0.6f;
+	bool coarseGating = false;
+	float coarseConfidenceThreshold = 0.2f;
 };
 
 struct DetectionParameters {
+	RenderMode renderMode = RenderMode::NONE;
 	double scaleFactor = 1.0;
 	cv::Scalar meanValues = { 104.0, 177.0, 123.0 };
 	float confidenceThreshold = 0.75f;
 	std::string inputName = "data";
 	std::string outputDetectionName = "detection_out";
 	std::string outputMaskName;
+	// an empty outputDetectionName forwards every unconnected output of the network, e.g. all YOLO heads
+	OutputLayout outputLayout = OutputLayout::SSD;
+	// YOLO boxes are in input pixels unless the network emits them normalized to [0, 1]
+	bool normalizedBoxes = false;
+	NmsParameters nmsParameters;
+	TilingParameters tilingParameters;
 	std::map<DetectionFeature, int> detectionFeatureMap = { 
+		{ dl::DetectionFeature::IMAGE_ID, 0 },
 		{ dl::DetectionFeature::CLASS_ID, 1 }, 
 		{ dl::DetectionFeature::CONFIDENCE, 2 },
 		{ dl::DetectionFeature::BBOX_LEFT, 3 },
@@ -166,85 +277,171 @@ struct DetectionParameters {
 	};
 };
 
+// maps a box from network input pixels back to the frame, frame = (input - pad) * scale
+// the frame is resized into inputSize and placed at the pad offset, letterboxing only moves the pad
+struct InputMapping {
+	cv::Size inputSize;
+	cv::Size frameSize;
+	float scaleX = 1.0f;
+	float scaleY = 1.0f;
+	float padX = 0.0f;
+	float padY = 0.0f;
+};
+
+class OutputDecoder;
+
 class Detector {
 public:
-	Detector(NetworkType type, const std::string& configFilePath, const std::string& weightFilePath)
-		: m_networkType(type), m_configFilePath(configFilePath), m_weightFilePath(weightFilePath) 
-	{
-		switch (m_networkType) {
-		case NetworkType::CAFFE: 
-		{
-			m_network = cv::dnn::readNetFromCaffe(m_configFilePath, m_weightFilePath);
-			m_network.setPreferableBackend(cv::dnn::DNN_BACKEND_CUDA);
-			m_network.setPreferableTarget(cv::dnn::DNN_TARGET_CUDA);
-			break;
-		}
-		case NetworkType::TENSORFLOW:
-		{
-			m_network = cv::dnn::readNetFromTensorflow(m_weightFilePath, m_configFilePath);
-			m_network.setPreferableBackend(cv::dnn::DNN_BACKEND_CUDA);
-			m_network.setPreferableTarget(cv::dnn::DNN_TARGET_CUDA);
-			break;
-		}
-		default: 
-		{
-			break;
-		}
-		}
-	}
+	Detector(const NetworkProperties& properties);
+	// creates the network from already loaded model files, a known backend choice skips the backend selection
+	Detector(const NetworkProperties& properties, const ModelBuffer& model, std::optional<BackendChoice> backendChoice = std::nullopt);
 
 	~Detector() {}
 
-	void SetDetectionParameters(DetectionParameters params) {
-		m_scaleFactor = params.scaleFactor;
-		m_meanValues = params.meanValues;
-		m_confidenceThreshold = params.confidenceThreshold;
-		m_inputName = params.inputName;
-		m_outputDetectionName = params.outputDetectionName;
-		m_outputMaskName = params.outputMaskName;
-		m_detectionFeatureMap = params.detectionFeatureMap;
-	}
+	void SetDetectionParameters(DetectionParameters params);
+
+	BackendChoice GetBackendChoice() const { return m_backendChoice; }
 
 	DetectionResult Detect(const cv::Mat& frame, std::optional<Object> oneClassNetwork);
+	// runs all frames through one forward pass, frames are packed into a single NCHW blob with the size of the first frame
+	std::vector<DetectionResult> DetectBatch(const std::vector<cv::Mat>& frames, std::optional<Object> oneClassNetwork);
 
+	// single steps of DetectBatch, CreateInputBlob and DecodeDetections only read the detector state and may run
+	// on other threads while Forward is busy, Forward itself must not be called concurrently
+	// every frame is resized to inputSize while the blob is written, inputBlob is reused when its shape fits
+	void CreateInputBlob(const std::vector<cv::Mat>& frames, cv::Size inputSize, cv::Mat& inputBlob) const;
+	std::vector<cv::Mat> Forward(const cv::Mat& inputBlob);
+	// forward pass with the input and output names of another detector of the same model, detectors sharing a pool
+	// keep their names in their own parameter copy
+	std::vector<cv::Mat> Forward(const cv::Mat& inputBlob, const Detector& parameters);
+	// boxes are mapped back to the frame they belong to and clipped to it, boxes left empty after clipping are dropped,
+	// overlapping boxes are suppressed afterwards when nmsParameters ask for it
+	// confidenceThreshold overrides the one of the detection parameters, e.g. for a coarse pass
+	void DecodeDetections(const std::vector<cv::Mat>& outs, const std::vector<InputMapping>& mappings, std::vector<DetectionResult>& results,
+		std::optional<Object> oneClassNetwork, std::optional<float> confidenceThreshold = std::nullopt) const;
+
+	// copy that shares the network but gets its own decoder, for blob creation and decoding with other detection
+	// parameters than the detectors of the pool it was copied from, it must not run forward passes itself
+	std::shared_ptr<Detector> CloneParameters() const;
+
+	// mapping of a frame that is stretched into the whole input
+	static InputMapping CreateInputMapping(cv::Size frameSize, cv::Size inputSize);
 	static std::string ConvertObjectTypeToString(Object object);
 	static Object ConvertObjectStringToType(const std::string& objectStr);
 
 private:
-	std::vector<std::string> GetOutputsNames(const cv::dnn::Net& net);
+	std::vector<std::string> GetOutputsNames();
+	void ApplyBackend(const NetworkProperties& properties, std::optional<BackendChoice> backendChoice);
 
 	std::string m_configFilePath = "";
 	std::string m_weightFilePath = "";
 	NetworkType m_networkType;
 	cv::dnn::Net m_network;
+	BackendChoice m_backendChoice;
+	std::vector<std::string> m_outputsNames;
+	cv::Mat m_inputBlob;
+	std::shared_ptr<OutputDecoder> m_outputDecoder;
+	OutputLayout m_outputLayout = OutputLayout::SSD;
 	// Detection Parameters
 	double m_scaleFactor = 0.0;
 	cv::Scalar m_meanValues;
-	float m_confidenceThreshold = 0.0f;
 	std::string m_inputName = "";
 	std::string m_outputDetectionName = "";
 	std::string m_outputMaskName = "";
-	std::map<DetectionFeature, int> m_detectionFeatureMap;
+	float m_confidenceThreshold = 0.0f;
+	NmsParameters m_nmsParameters;
 	// Logger
 	static std::shared_ptr<base::Logger> m_logger;
 };
 
+class DetectorPool;
+
+// state of one frame while it travels through the detection stages
+struct DetectionContext {
+	cv::Mat frame;
+	std::optional<Object> oneClassNetwork;
+	bool oneObject = false;
+	InputMapping inputMapping;
+	cv::Mat inputBlob;
+	std::vector<cv::Mat> outputs;
+	DetectionResult result;
+};
+
+// motion gate and the detections of the last gated frame of one stream, owned by the caller of DetectGated the way
+// the Tracker owns its MotionGate, so that one detector can gate several streams from several threads
+struct GatedStream {
+	GatedStream(const MotionGatingParameters& params = MotionGatingParameters()) { motionGate.SetParameters(params); }
+
+	MotionGate motionGate;
+	std::vector<Detection> lastDetections;
+};
+
 class BaseDetector {
 public:
 	BaseDetector() {}
-	~BaseDetector() {}
+	virtual ~BaseDetector() {}
 
 	virtual void InitializeNetworkPaths() = 0;
 
-	void SetDetectionParameters(DetectionParameters params) {
-		m_detector->SetDetectionParameters(params);
-	}
+	void SetDetectionParameters(DetectionParameters params);
+	// number of networks that may run at the same time, 0 uses the number of hardware threads, the limit holds for
+	// all detectors of the same model since they share one pool
+	void SetMaxConcurrency(size_t maxNetworks);
 
-	virtual DetectionResult Detect(const cv::Mat& frame, std::optional<Object> oneClassNetwork, bool oneObject = false) = 0;
+	// Detect, DetectBatch and the stages may be called from several threads, every forward pass leases its own network
+	// with tiling enabled Detect and DetectBatch go through DetectTiled, the single stages never tile
+	virtual DetectionResult Detect(const cv::Mat& frame, std::optional<Object> oneClassNetwork, bool oneObject = false);
+	virtual std::vector<DetectionResult> DetectBatch(const std::vector<cv::Mat>& frames, std::optional<Object> oneClassNetwork, bool oneObject = false);
+
+	// detection stages in the order Detect runs them, every stage only touches its own context so that
+	// consecutive frames can be in different stages at the same time (see dl::DetectionPipeline)
+	void Preprocess(DetectionContext& context) const;
+	void Forward(DetectionContext& context);
+	void Postprocess(DetectionContext& context) const;
+	virtual void EstimateAttributes(DetectionContext& context) {}
+	void Render(DetectionContext& context) const;
+	// Preprocess, Forward and Postprocess of several contexts with one forward pass, used by DetectBatch, the
+	// oneClassNetwork of the first context applies to all of them
+	void DetectContexts(const std::vector<DetectionContext*>& contexts);
+
+	// full frame pass plus overlapping tiles at native resolution, finds objects that vanish when the frame is shrunk
+	DetectionResult DetectTiled(const cv::Mat& frame, std::optional<Object> oneClassNetwork, bool oneObject = false);
+	// Detect behind the motion gate of the stream: static frames return the previous detections and changed regions
+	// are detected alone while the detections outside of them are kept, frames of one stream must come in order and
+	// from one thread at a time
+	DetectionResult DetectGated(const cv::Mat& frame, GatedStream& stream, std::optional<Object> oneClassNetwork, bool oneObject = false);
 
 protected:
+	// frames are resized so that their short side matches the network input before detection
+	double CalculateResizeRatio(const cv::Mat& frame) const {
+		auto ratioWidth = static_cast<double>(frame.size().width) / static_cast<double>(m_networkProperties.imageInputWidth);
+		auto ratioHeight = static_cast<double>(frame.size().height) / static_cast<double>(m_networkProperties.imageInputHeight);
+		return ratioWidth < ratioHeight ? ratioWidth : ratioHeight;
+	}
+
+	cv::Size CalculateInputSize(const cv::Mat& frame, double ratio) const {
+		// ONNX graphs are exported with a fixed input shape, frames are stretched into it
+		if (m_networkProperties.networkType == NetworkType::ONNX)
+			return cv::Size(m_networkProperties.imageInputWidth, m_networkProperties.imageInputHeight);
+		return cv::Size(static_cast<int>(frame.size().width / ratio), static_cast<int>(frame.size().height / ratio));
+	}
+
+	// takes the detector pool of m_networkProperties from the ModelRegistry, called by the constructors of the derived classes
+	void InitializeDetector();
+	// detections of one region, boxes are mapped to the frame the region was cut from
+	std::vector<Detection> DetectRegion(const cv::Mat& frame, const cv::Rect& region, std::optional<Object> oneClassNetwork);
+	// tiles covering the frame, with coarseGating only those touching one of the regions
+	std::vector<cv::Rect> CalculateTiles(const cv::Size& frameSize, const std::vector<cv::Rect>& regions) const;
+	// boxes are already in frame coordinates, keeps the one closest to the center for oneObject
+	virtual void PostprocessDetections(DetectionContext& context) const;
+
+	std::shared_ptr<DetectorPool> m_detectorPool;
+	// parameter copy of the pool prototype, only used for the const steps of the detection
 	std::shared_ptr<Detector> m_detector;
 	NetworkProperties m_networkProperties;
+	RenderMode m_renderMode = RenderMode::NONE;
+	float m_confidenceThreshold = 0.0f;
+	TilingParameters m_tilingParameters;
 
 };
 
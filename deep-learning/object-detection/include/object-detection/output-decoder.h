@@ -0,0 +1,36 @@
+#pragma once
+
+#include <object-detection/object-detection.h>
+#include <algorithm>
+
+namespace dl {
+
+// turns the raw network outputs into detections in frame coordinates, one implementation per output layout
+class OutputDecoder {
+public:
+	virtual ~OutputDecoder() {}
+
+	static std::shared_ptr<OutputDecoder> Create(OutputLayout layout);
+
+	virtual void SetDetectionParameters(const DetectionParameters& params) = 0;
+	// rows of all images of a batch are decoded into the result of their image, boxes are clipped to the frame
+	virtual void Decode(const std::vector<cv::Mat>& outs, const std::vector<InputMapping>& mappings, std::vector<DetectionResult>& results,
+		std::optional<Object> oneClassNetwork, float confidenceThreshold) const = 0;
+
+protected:
+	// maps corners given in input pixels back to the frame, false when nothing of the box is left after clipping
+	static bool MapBox(const InputMapping& mapping, float left, float top, float right, float bottom, cv::Rect& bbox) {
+		const float maxX = static_cast<float>(mapping.frameSize.width);
+		const float maxY = static_cast<float>(mapping.frameSize.height);
+		const int x = static_cast<int>(std::clamp((left - mapping.padX) * mapping.scaleX, 0.0f, maxX));
+		const int y = static_cast<int>(std::clamp((top - mapping.padY) * mapping.scaleY, 0.0f, maxY));
+		const int width = static_cast<int>(std::clamp((right - mapping.padX) * mapping.scaleX, 0.0f, maxX)) - x;
+		const int height = static_cast<int>(std::clamp((bottom - mapping.padY) * mapping.scaleY, 0.0f, maxY)) - y;
+		if (width <= 0 || height <= 0)
+			return false;
+		bbox = cv::Rect(x, y, width, height);
+		return true;
+	}
+};
+
+}
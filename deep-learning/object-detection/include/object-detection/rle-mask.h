@@ -0,0 +1,74 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace dl {
+
+// run-length encoded binary mask placed at a bbox in frame coordinates, similar to COCO RLE but in row-major order
+// so runs map to image rows, counts alternate between background and foreground and always start with background
+class RleMask {
+public:
+	RleMask() = default;
+
+	// encodes the non-zero pixels of a CV_8U mask of the bbox size
+	static RleMask Encode(const cv::Mat& mask, const cv::Rect& bbox);
+	// writes the mask into a CV_8U roi of the bbox size, 255 inside and 0 outside
+	void Decode(cv::Mat& roi) const;
+
+	// the following work on the runs directly and never decode the masks
+	static size_t Intersection(const RleMask& a, const RleMask& b);
+	static float IntersectionOverUnion(const RleMask& a, const RleMask& b);
+	// union of both masks placed at the union of both bboxes
+	static RleMask Union(const RleMask& a, const RleMask& b);
+
+	// calls func(row, begin, end) for every foreground interval in frame coordinates, rows ascending
+	template<typename Func>
+	void ForEachInterval(Func func) const;
+
+	const cv::Rect& GetBbox() const { return m_bbox; }
+	// the runs are relative to the box, moving the mask only moves the box
+	void Translate(const cv::Point& offset) { m_bbox += offset; }
+	const std::vector<uint32_t>& GetCounts() const { return m_counts; }
+	size_t Area() const { return m_area; }
+	bool Empty() const { return m_area == 0; }
+	size_t MemoryBytes() const { return sizeof(RleMask) + m_counts.capacity() * sizeof(uint32_t); }
+
+private:
+	// appends the foreground pixels [begin, end) given as row-major offsets inside the bbox, begin must not lie
+	// before the end of the previous foreground run
+	void AppendForeground(size_t begin, size_t end);
+	void Finish();
+
+	cv::Rect m_bbox;
+	std::vector<uint32_t> m_counts;
+	size_t m_area = 0;
+	size_t m_length = 0;
+};
+
+template<typename Func>
+void
+RleMask::ForEachInterval(Func func) const {
+	if (m_bbox.width <= 0)
+		return;
+	size_t position = 0;
+	for (size_t i = 0; i < m_counts.size(); ++i) {
+		const size_t end = position + m_counts[i];
+		// odd entries are foreground runs, which may wrap over several rows of the bbox
+		if (i % 2 == 1) {
+			size_t begin = position;
+			while (begin < end) {
+				const int row = static_cast<int>(begin / m_bbox.width);
+				const size_t rowEnd = std::min(end, static_cast<size_t>(row + 1) * m_bbox.width);
+				const int x = static_cast<int>(begin - static_cast<size_t>(row) * m_bbox.width);
+				func(m_bbox.y + row, m_bbox.x + x, m_bbox.x + x + static_cast<int>(rowEnd - begin));
+				begin = rowEnd;
+			}
+		}
+		position = end;
+	}
+}
+
+}
\ No newline at end of file
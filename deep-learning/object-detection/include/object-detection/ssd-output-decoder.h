@@ -0,0 +1,28 @@
+#pragma once
+
+#include <object-detection/output-decoder.h>
+
+namespace dl {
+
+// decodes the [1, 1, N, 7] detection_out tensor of SSD style networks, rows of all images of a batch are stacked
+class SsdOutputDecoder : public OutputDecoder {
+public:
+	// resolves the column of every feature once, decoding does not look into the feature map anymore
+	void SetDetectionParameters(const DetectionParameters& params) override;
+
+	// confidence filter, mapping back to the frame and clipping in one sweep over the rows
+	void Decode(const std::vector<cv::Mat>& outs, const std::vector<InputMapping>& mappings, std::vector<DetectionResult>& results,
+		std::optional<Object> oneClassNetwork, float confidenceThreshold) const override;
+
+private:
+	int m_imageIdColumn = 0;
+	int m_classIdColumn = 1;
+	int m_confidenceColumn = 2;
+	int m_leftColumn = 3;
+	int m_topColumn = 4;
+	int m_rightColumn = 5;
+	int m_bottomColumn = 6;
+	bool m_hasMaskOutput = false;
+};
+
+}
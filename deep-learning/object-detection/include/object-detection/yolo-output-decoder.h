@@ -0,0 +1,37 @@
+#pragma once
+
+#include <object-detection/output-decoder.h>
+#include <memory>
+
+namespace base {
+	class Logger;
+}
+
+namespace dl {
+
+// decodes YOLO style outputs, every output is a [B * N, 5 + C] or [B, N, 5 + C] grid of (cx, cy, w, h, objectness, class scores)
+// rows, several outputs (one per detection head) are decoded one after the other, overlapping boxes are left to the NMS
+class YoloOutputDecoder : public OutputDecoder {
+public:
+	void SetDetectionParameters(const DetectionParameters& params) override;
+
+	// the rows of a grid are split into chunks that are decoded in parallel and merged in order
+	void Decode(const std::vector<cv::Mat>& outs, const std::vector<InputMapping>& mappings, std::vector<DetectionResult>& results,
+		std::optional<Object> oneClassNetwork, float confidenceThreshold) const override;
+
+private:
+	struct Candidate {
+		int classId;
+		float confidence;
+		cv::Rect bbox;
+	};
+
+	void DecodeRows(const float* data, int begin, int end, int cols, const InputMapping& mapping, float confidenceThreshold,
+		std::vector<Candidate>& candidates) const;
+
+	bool m_normalizedBoxes = false;
+	static constexpr int ROWS_PER_CHUNK = 1024;
+	static std::shared_ptr<base::Logger> m_logger;
+};
+
+}
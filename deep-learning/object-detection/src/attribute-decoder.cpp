@@ -0,0 +1,66 @@
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <cmath>
+
+#include "object-detection/attribute-decoder.h"
+
+namespace dl {
+
+AttributeEstimation
+AttributeDecoder::Decode(const cv::Mat& scores, const std::vector<std::string>& labels, int topK) {
+	AttributeEstimation retVal;
+	const float* data = scores.ptr<float>();
+	const int count = static_cast<int>(scores.total());
+	if (count == 0)
+		return retVal;
+
+	float maxScore = data[0];
+	float minScore = data[0];
+	double sum = 0.0;
+	for (int i = 0; i < count; ++i) {
+		if (data[i] > maxScore) {
+			maxScore = data[i];
+			retVal.classId = i;
+		}
+		minScore = std::min(minScore, data[i]);
+		sum += data[i];
+	}
+	if (retVal.classId < 0)
+		retVal.classId = 0;
+
+	// most models end with a softmax, raw scores are normalized on the fly
+	bool isDistribution = minScore >= 0.0f && std::abs(sum - 1.0) < 1e-3;
+	double denominator = 1.0;
+	if (!isDistribution) {
+		denominator = 0.0;
+		for (int i = 0; i < count; ++i)
+			denominator += std::exp(data[i] - maxScore);
+	}
+	auto Probability = [&](int index) {
+		return isDistribution ? data[index] : static_cast<float>(std::exp(data[index] - maxScore) / denominator);
+	};
+
+	retVal.probability = Probability(retVal.classId);
+	if (retVal.classId < static_cast<int>(labels.size()))
+		retVal.label = labels[retVal.classId];
+
+	// insertion into the fixed size top list, the class count of attribute models is small
+	topK = std::min(std::min(topK, AttributeEstimation::MAX_TOP_K), count);
+	for (int i = 0; i < count && topK > 0; ++i) {
+		int position = retVal.topCount;
+		while (position > 0 && data[retVal.topClassIds[position - 1]] < data[i]) {
+			if (position < topK)
+				retVal.topClassIds[position] = retVal.topClassIds[position - 1];
+			--position;
+		}
+		if (position < topK) {
+			retVal.topClassIds[position] = i;
+			retVal.topCount = std::min(retVal.topCount + 1, topK);
+		}
+	}
+	for (int i = 0; i < retVal.topCount; ++i)
+		retVal.topProbabilities[i] = Probability(retVal.topClassIds[i]);
+	return retVal;
+}
+
+}
@@ -0,0 +1,87 @@
+#include <logger/logger.h>
+#include <opencv2/core.hpp>
+#include <algorithm>
+
+#include "object-detection/attribute-network.h"
+#include "object-detection/backend-selector.h"
+#include "object-detection/blob-builder.h"
+#include "object-detection/model-registry.h"
+
+std::shared_ptr<base::Logger> dl::AttributeNetwork::m_logger = std::make_shared<base::Logger>();
+
+namespace dl {
+
+AttributeNetwork::AttributeNetwork(const NetworkProperties& properties, const std::string& inputName, const std::vector<std::string>& outputNames)
+	: m_networkProperties(properties), m_inputName(inputName), m_outputNames(outputNames) {
+	m_network = ModelRegistry::CreateNetwork(m_networkProperties);
+	if (!m_network.empty())
+		BackendSelector::Apply(m_network, m_networkProperties);
+}
+
+std::vector<cv::Mat>
+AttributeNetwork::Forward(const std::vector<cv::Mat>& faces) {
+	std::vector<cv::Mat> retVal;
+	const cv::Size inputSize(m_networkProperties.imageInputWidth, m_networkProperties.imageInputHeight);
+	for (size_t first = 0; first < faces.size(); first += m_maxBatchSize) {
+		auto last = std::min(faces.size(), first + m_maxBatchSize);
+		// resize, mean subtraction and layout conversion in one pass into the reused blob
+		BlobBuilder::CreateBlob(std::vector<cv::Mat>(faces.begin() + first, faces.begin() + last), inputSize, 1.0,
+			m_networkProperties.meanValues, false, m_inputBlob);
+		auto outs = ForwardBlob(m_inputBlob);
+		retVal.resize(outs.size());
+		for (size_t i = 0; i < outs.size(); ++i)
+			retVal[i].push_back(outs[i]);
+	}
+	return retVal;
+}
+
+std::vector<cv::Mat>
+AttributeNetwork::ForwardBlob(const cv::Mat& inputBlob) {
+	const int count = inputBlob.size[0];
+	if (m_batchSupported || count == 1) {
+		try {
+			return ForwardStacked(inputBlob);
+		}
+		catch (const cv::Exception& e) {
+			if (count == 1)
+				throw;
+			std::string logMsg = "Batched estimation failed for " + m_networkProperties.weightFilePath + ", retrying face by face: " + e.what();
+			m_logger->LogWarn(logMsg.c_str());
+		}
+	}
+
+	std::vector<cv::Mat> retVal;
+	for (int i = 0; i < count; ++i) {
+		auto outs = ForwardStacked(BlobBuilder::SliceBlob(inputBlob, i));
+		retVal.resize(outs.size());
+		for (size_t j = 0; j < outs.size(); ++j)
+			retVal[j].push_back(outs[j]);
+	}
+	// only a model that runs single faces but not stacked ones lacks batch support, other errors were thrown above
+	if (m_batchSupported && count > 1) {
+		m_batchSupported = false;
+		std::string logMsg = "Batched estimation is not supported by " + m_networkProperties.weightFilePath + ", estimating face by face";
+		m_logger->LogWarn(logMsg.c_str());
+	}
+	return retVal;
+}
+
+std::vector<cv::Mat>
+AttributeNetwork::ForwardStacked(const cv::Mat& inputBlob) {
+	const int count = inputBlob.size[0];
+	if (m_inputName.empty())
+		m_network.setInput(inputBlob);
+	else
+		m_network.setInput(inputBlob, m_inputName);
+	std::vector<cv::Mat> outs;
+	if (m_outputNames.empty())
+		outs.push_back(m_network.forward());
+	else
+		m_network.forward(outs, m_outputNames);
+	// the outputs are views of the network buffers, every one is copied into count rows of class scores
+	for (auto& out : outs)
+		out = cv::Mat(count, static_cast<int>(out.total()) / count, CV_32F, out.ptr<float>()).clone();
+	return outs;
+}
+
+}
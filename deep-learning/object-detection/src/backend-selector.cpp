@@ -0,0 +1,292 @@
+#include <logger/logger.h>
+#include <assertion/assertion.h>
+#include <file/file.h>
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <filesystem>
+
+#include "object-detection/backend-selector.h"
+
+std::string dl::BackendSelector::m_cachePath = "backend-cache.yml";
+int dl::BackendSelector::m_warmupIterations = 3;
+std::mutex dl::BackendSelector::m_cacheMutex;
+std::shared_ptr<base::Logger> dl::BackendSelector::m_logger = std::make_shared<base::Logger>();
+
+namespace dl {
+
+BackendChoice
+BackendSelector::Apply(cv::dnn::Net& network, const NetworkProperties& properties) {
+	auto key = CreateCacheKey(properties);
+	if (properties.backendPolicy == BackendPolicy::AUTO) {
+		auto cachedChoice = ReadCache(key);
+		if (cachedChoice.has_value()) {
+			network.setPreferableBackend(cachedChoice.value().backend);
+			network.setPreferableTarget(cachedChoice.value().target);
+			std::string logMsg = "Using cached backend " + ConvertBackendChoiceToString(cachedChoice.value()) + " for " + properties.weightFilePath;
+			m_logger->LogInfo(logMsg.c_str());
+			return cachedChoice.value();
+		}
+	}
+
+	// without a known input size the network can not be warmed up, stay on the default cpu path
+	if (properties.imageInputWidth <= 0 || properties.imageInputHeight <= 0) {
+		BackendChoice defaultChoice;
+		network.setPreferableBackend(defaultChoice.backend);
+		network.setPreferableTarget(defaultChoice.target);
+		return defaultChoice;
+	}
+
+	int blobSizes[] = { 1, 3, properties.imageInputHeight, properties.imageInputWidth };
+	cv::Mat inputBlob(4, blobSizes, CV_32F, cv::Scalar(0));
+
+	std::optional<BackendChoice> bestChoice;
+	for (auto& candidate : GetCandidates(properties.backendPolicy, properties.precision)) {
+		auto inferenceTime = Benchmark(network, candidate, inputBlob);
+		if (!inferenceTime.has_value())
+			continue;
+		candidate.inferenceTimeMs = inferenceTime.value();
+		if (!bestChoice.has_value() || candidate.inferenceTimeMs < bestChoice.value().inferenceTimeMs)
+			bestChoice = candidate;
+	}
+
+	if (!bestChoice.has_value()) {
+		std::string logMsg = "No requested backend is usable for " + properties.weightFilePath + ", falling back to OpenCV/CPU";
+		m_logger->LogWarn(logMsg.c_str());
+		bestChoice = BackendChoice();
+	}
+
+	if (properties.precision == Precision::FP16 && bestChoice.value().target == cv::dnn::DNN_TARGET_CPU) {
+		std::string logMsg = "No FP16 target is usable for " + properties.weightFilePath + ", the CPU computes in FP32";
+		m_logger->LogWarn(logMsg.c_str());
+	}
+
+	network.setPreferableBackend(bestChoice.value().backend);
+	network.setPreferableTarget(bestChoice.value().target);
+	std::string logMsg = "Selected backend " + ConvertBackendChoiceToString(bestChoice.value()) + " for " + properties.weightFilePath +
+		" (" + std::to_string(bestChoice.value().inferenceTimeMs) + " ms)";
+	m_logger->LogInfo(logMsg.c_str());
+
+	if (properties.backendPolicy == BackendPolicy::AUTO)
+		WriteCache(key, bestChoice.value());
+
+	return bestChoice.value();
+}
+
+std::vector<BackendChoice>
+BackendSelector::GetCandidates(BackendPolicy policy, Precision precision) {
+	std::vector<BackendChoice> candidates;
+	for (const auto& candidate : GetPolicyCandidates(policy)) {
+		auto choice = ApplyPrecision(candidate, precision);
+		bool known = std::any_of(candidates.begin(), candidates.end(), [&choice](const BackendChoice& other) {
+			return other.backend == choice.backend && other.target == choice.target;
+		});
+		if (!known)
+			candidates.push_back(choice);
+	}
+	return candidates;
+}
+
+BackendChoice
+BackendSelector::ApplyPrecision(const BackendChoice& choice, Precision precision) {
+	BackendChoice retVal = choice;
+	switch (precision) {
+	case Precision::FP16:
+	{
+		if (choice.target == cv::dnn::DNN_TARGET_CUDA)
+			retVal.target = cv::dnn::DNN_TARGET_CUDA_FP16;
+		else if (choice.target == cv::dnn::DNN_TARGET_OPENCL)
+			retVal.target = cv::dnn::DNN_TARGET_OPENCL_FP16;
+		break;
+	}
+	case Precision::INT8:
+	{
+		// quantized layers are only implemented by the OpenCV backend on the CPU
+		retVal.backend = cv::dnn::DNN_BACKEND_OPENCV;
+		retVal.target = cv::dnn::DNN_TARGET_CPU;
+		break;
+	}
+	case Precision::FP32:
+	default:
+	{
+		if (choice.target == cv::dnn::DNN_TARGET_CUDA_FP16)
+			retVal.target = cv::dnn::DNN_TARGET_CUDA;
+		else if (choice.target == cv::dnn::DNN_TARGET_OPENCL_FP16)
+			retVal.target = cv::dnn::DNN_TARGET_OPENCL;
+		break;
+	}
+	}
+	return retVal;
+}
+
+std::string
+BackendSelector::ConvertPrecisionToString(Precision precision) {
+	switch (precision) {
+	case Precision::FP16: return "FP16";
+	case Precision::INT8: return "INT8";
+	case Precision::FP32:
+	default: return "FP32";
+	}
+}
+
+std::vector<BackendChoice>
+BackendSelector::GetPolicyCandidates(BackendPolicy policy) {
+	auto MakeChoice = [](cv::dnn::Backend backend, cv::dnn::Target target) {
+		BackendChoice choice;
+		choice.backend = backend;
+		choice.target = target;
+		return choice;
+	};
+
+	switch (policy) {
+	case BackendPolicy::AUTO:
+	{
+		std::vector<BackendChoice> candidates;
+		for (const auto& pair : cv::dnn::getAvailableBackends()) {
+			candidates.push_back(MakeChoice(pair.first, pair.second));
+		}
+		if (candidates.empty())
+			candidates.push_back(BackendChoice());
+		return candidates;
+	}
+	case BackendPolicy::OPENCV_CPU: return { MakeChoice(cv::dnn::DNN_BACKEND_OPENCV, cv::dnn::DNN_TARGET_CPU) };
+	case BackendPolicy::OPENCV_OPENCL: return { MakeChoice(cv::dnn::DNN_BACKEND_OPENCV, cv::dnn::DNN_TARGET_OPENCL) };
+	case BackendPolicy::OPENCV_OPENCL_FP16: return { MakeChoice(cv::dnn::DNN_BACKEND_OPENCV, cv::dnn::DNN_TARGET_OPENCL_FP16) };
+	case BackendPolicy::INFERENCE_ENGINE_CPU: return { MakeChoice(cv::dnn::DNN_BACKEND_INFERENCE_ENGINE, cv::dnn::DNN_TARGET_CPU) };
+	case BackendPolicy::INFERENCE_ENGINE_OPENCL_FP16: return { MakeChoice(cv::dnn::DNN_BACKEND_INFERENCE_ENGINE, cv::dnn::DNN_TARGET_OPENCL_FP16) };
+	case BackendPolicy::INFERENCE_ENGINE_MYRIAD: return { MakeChoice(cv::dnn::DNN_BACKEND_INFERENCE_ENGINE, cv::dnn::DNN_TARGET_MYRIAD) };
+	case BackendPolicy::CUDA: return { MakeChoice(cv::dnn::DNN_BACKEND_CUDA, cv::dnn::DNN_TARGET_CUDA) };
+	case BackendPolicy::CUDA_FP16: return { MakeChoice(cv::dnn::DNN_BACKEND_CUDA, cv::dnn::DNN_TARGET_CUDA_FP16) };
+	default: return { BackendChoice() };
+	}
+}
+
+std::string
+BackendSelector::ConvertBackendChoiceToString(const BackendChoice& choice) {
+	std::string backend;
+	switch (choice.backend) {
+	case cv::dnn::DNN_BACKEND_DEFAULT: backend = "Default"; break;
+	case cv::dnn::DNN_BACKEND_HALIDE: backend = "Halide"; break;
+	case cv::dnn::DNN_BACKEND_INFERENCE_ENGINE: backend = "InferenceEngine"; break;
+	case cv::dnn::DNN_BACKEND_OPENCV: backend = "OpenCV"; break;
+	case cv::dnn::DNN_BACKEND_VKCOM: backend = "Vulkan"; break;
+	case cv::dnn::DNN_BACKEND_CUDA: backend = "CUDA"; break;
+	default: backend = "Unknown"; break;
+	}
+	std::string target;
+	switch (choice.target) {
+	case cv::dnn::DNN_TARGET_CPU: target = "CPU"; break;
+	case cv::dnn::DNN_TARGET_OPENCL: target = "OpenCL"; break;
+	case cv::dnn::DNN_TARGET_OPENCL_FP16: target = "OpenCL FP16"; break;
+	case cv::dnn::DNN_TARGET_MYRIAD: target = "Myriad"; break;
+	case cv::dnn::DNN_TARGET_VULKAN: target = "Vulkan"; break;
+	case cv::dnn::DNN_TARGET_FPGA: target = "FPGA"; break;
+	case cv::dnn::DNN_TARGET_CUDA: target = "CUDA"; break;
+	case cv::dnn::DNN_TARGET_CUDA_FP16: target = "CUDA FP16"; break;
+	default: target = "Unknown"; break;
+	}
+	return backend + "/" + target;
+}
+
+std::optional<double>
+BackendSelector::Benchmark(cv::dnn::Net& network, const BackendChoice& choice, const cv::Mat& inputBlob) {
+	try {
+		network.setPreferableBackend(choice.backend);
+		network.setPreferableTarget(choice.target);
+		// first pass initializes the backend and is not measured
+		network.setInput(inputBlob);
+		network.forward();
+		cv::TickMeter tm;
+		int iterations = std::max(m_warmupIterations, 1);
+		for (int i = 0; i < iterations; ++i) {
+			network.setInput(inputBlob);
+			tm.start();
+			network.forward();
+			tm.stop();
+		}
+		return tm.getTimeMilli() / static_cast<double>(iterations);
+	}
+	catch (const cv::Exception& e) {
+		std::string logMsg = "Backend " + ConvertBackendChoiceToString(choice) + " is not usable: " + e.what();
+		m_logger->LogWarn(logMsg.c_str());
+		return std::nullopt;
+	}
+}
+
+std::string
+BackendSelector::CreateCacheKey(const NetworkProperties& properties) {
+	// file size and modification time are part of the key so that a replaced model is probed again
+	std::error_code ec;
+	auto fileSize = std::filesystem::file_size(properties.weightFilePath, ec);
+	if (ec)
+		fileSize = 0;
+	auto writeTime = std::filesystem::last_write_time(properties.weightFilePath, ec);
+	long long writeTicks = ec ? 0 : static_cast<long long>(writeTime.time_since_epoch().count());
+	return properties.weightFilePath + "|" + std::to_string(fileSize) + "|" + std::to_string(writeTicks) + "|" +
+		std::to_string(properties.imageInputWidth) + "x" + std::to_string(properties.imageInputHeight) + "|" + ConvertPrecisionToString(properties.precision);
+}
+
+std::optional<BackendChoice>
+BackendSelector::ReadCache(const std::string& key) {
+	std::lock_guard<std::mutex> lock(m_cacheMutex);
+	if (!std::filesystem::exists(m_cachePath))
+		return std::nullopt;
+	cv::FileStorage fs(m_cachePath, cv::FileStorage::READ);
+	if (!fs.isOpened())
+		return std::nullopt;
+	cv::FileNode models = fs["models"];
+	for (auto it = models.begin(); it != models.end(); ++it) {
+		cv::FileNode model = *it;
+		if (static_cast<std::string>(model["key"]) != key)
+			continue;
+		BackendChoice choice;
+		choice.backend = static_cast<cv::dnn::Backend>(static_cast<int>(model["backend"]));
+		choice.target = static_cast<cv::dnn::Target>(static_cast<int>(model["target"]));
+		choice.inferenceTimeMs = static_cast<double>(model["inferenceTimeMs"]);
+		return choice;
+	}
+	return std::nullopt;
+}
+
+void
+BackendSelector::WriteCache(const std::string& key, const BackendChoice& choice) {
+	std::lock_guard<std::mutex> lock(m_cacheMutex);
+	// keep the entries of the other models
+	std::vector<std::pair<std::string, BackendChoice>> entries;
+	if (std::filesystem::exists(m_cachePath)) {
+		cv::FileStorage fs(m_cachePath, cv::FileStorage::READ);
+		if (fs.isOpened()) {
+			cv::FileNode models = fs["models"];
+			for (auto it = models.begin(); it != models.end(); ++it) {
+				cv::FileNode model = *it;
+				std::string modelKey = static_cast<std::string>(model["key"]);
+				if (modelKey == key)
+					continue;
+				BackendChoice modelChoice;
+				modelChoice.backend = static_cast<cv::dnn::Backend>(static_cast<int>(model["backend"]));
+				modelChoice.target = static_cast<cv::dnn::Target>(static_cast<int>(model["target"]));
+				modelChoice.inferenceTimeMs = static_cast<double>(model["inferenceTimeMs"]);
+				entries.push_back(std::make_pair(modelKey, modelChoice));
+			}
+		}
+	}
+	entries.push_back(std::make_pair(key, choice));
+
+	cv::FileStorage fs(m_cachePath, cv::FileStorage::WRITE);
+	if (!fs.isOpened()) {
+		std::string logMsg = "Backend cache " + m_cachePath + " can not be written";
+		m_logger->LogWarn(logMsg.c_str());
+		return;
+	}
+	fs << "models" << "[";
+	for (const auto& entry : entries) {
+		fs << "{";
+		fs << "key" << entry.first;
+		fs << "backend" << static_cast<int>(entry.second.backend);
+		fs << "target" << static_cast<int>(entry.second.target);
+		fs << "inferenceTimeMs" << entry.second.inferenceTimeMs;
+		fs << "}";
+	}
+	fs << "]";
+}
+
+}
@@ -0,0 +1,296 @@
+#include <object-detection/blob-builder.h>
+#include <object-detection/ssd-output-decoder.h>
+#include <object-detection/yolo-output-decoder.h>
+#include <object-detection/non-maximum-suppression.h>
+#include <object-detection/mask-processor.h>
+#include <cxxopts.hpp>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/dnn.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+// runs func iterations times after one warm up call and returns the average time in milliseconds
+template<typename Func>
+double MeasureMs(int iterations, Func func) {
+	func();
+	cv::TickMeter timer;
+	timer.start();
+	for (int i = 0; i < iterations; ++i)
+		func();
+	timer.stop();
+	return timer.getTimeMilli() / iterations;
+}
+
+void BenchmarkPreprocessing(const cv::Mat& frame, int iterations) {
+	const cv::Scalar meanValues(104.0, 177.0, 123.0);
+	const double scaleFactor = 1.0;
+	const std::vector<cv::Size> sizes = { cv::Size(300, 300), cv::Size(227, 227), cv::Size(200, 200) };
+
+	std::cout << "Preprocessing of a " << frame.cols << "x" << frame.rows << " frame, " << iterations << " iterations" << std::endl;
+	std::cout << std::left << std::setw(12) << "size" << std::setw(16) << "resize+blob" << std::setw(16) << "fused"
+		<< std::setw(10) << "speedup" << std::setw(12) << "max diff" << std::endl;
+	for (const auto& size : sizes) {
+		for (bool swapRB : { false, true }) {
+			cv::Mat resizedFrame, referenceBlob, fusedBlob;
+			auto referenceMs = MeasureMs(iterations, [&]() {
+				cv::resize(frame, resizedFrame, size);
+				referenceBlob = cv::dnn::blobFromImage(resizedFrame, scaleFactor, size, meanValues, swapRB, false);
+			});
+			auto fusedMs = MeasureMs(iterations, [&]() {
+				dl::BlobBuilder::CreateBlob({ frame }, size, scaleFactor, meanValues, swapRB, fusedBlob);
+			});
+			// the fused kernel interpolates in float while cv::resize rounds to 8 bit, differences stay below one gray level
+			auto maxDiff = cv::norm(referenceBlob.reshape(1, 1), fusedBlob.reshape(1, 1), cv::NORM_INF);
+			std::string name = std::to_string(size.width) + "x" + std::to_string(size.height) + (swapRB ? " rgb" : "");
+			std::cout << std::left << std::setw(12) << name << std::setw(16) << referenceMs << std::setw(16) << fusedMs
+				<< std::setw(10) << referenceMs / fusedMs << std::setw(12) << maxDiff << std::endl;
+		}
+	}
+}
+
+// decoding as it was done before the SsdOutputDecoder, feature map lookups per row and a second pass for the resize ratio
+void DecodeWithFeatureMap(const cv::Mat& detection, const dl::DetectionParameters& params, cv::Size inputSize, double ratio, cv::Size frameSize,
+	std::vector<dl::Detection>& detections) {
+	cv::Mat detectionMatrix(detection.size[2], detection.size[3], CV_32F, const_cast<float*>(detection.ptr<float>()));
+	const auto& featureMap = params.detectionFeatureMap;
+	std::vector<dl::Detection> decoded;
+	for (int i = 0; i < detectionMatrix.rows; i++) {
+		float confidence = detectionMatrix.at<float>(i, featureMap.at(dl::DetectionFeature::CONFIDENCE));
+		if (confidence < params.confidenceThreshold)
+			continue;
+		int left = static_cast<int>(detectionMatrix.at<float>(i, featureMap.at(dl::DetectionFeature::BBOX_LEFT)) * inputSize.width);
+		int top = static_cast<int>(detectionMatrix.at<float>(i, featureMap.at(dl::DetectionFeature::BBOX_TOP)) * inputSize.height);
+		int right = static_cast<int>(detectionMatrix.at<float>(i, featureMap.at(dl::DetectionFeature::BBOX_RIGHT)) * inputSize.width);
+		int bottom = static_cast<int>(detectionMatrix.at<float>(i, featureMap.at(dl::DetectionFeature::BBOX_BOTTOM)) * inputSize.height);
+		dl::Detection res;
+		res.bbox = cv::Rect(left, top, right - left, bottom - top);
+		res.confidence = confidence;
+		res.classId = static_cast<int>(detectionMatrix.at<float>(i, featureMap.at(dl::DetectionFeature::CLASS_ID)));
+		decoded.push_back(res);
+	}
+	detections.clear();
+	for (auto& det : decoded) {
+		if ((det.bbox.x + det.bbox.width) * ratio > frameSize.width || (det.bbox.y + det.bbox.height) * ratio > frameSize.height)
+			continue;
+		det.bbox.x *= ratio;
+		det.bbox.y *= ratio;
+		det.bbox.width *= ratio;
+		det.bbox.height *= ratio;
+		detections.push_back(det);
+	}
+}
+
+void BenchmarkDecoding(const cv::Mat& frame, int iterations) {
+	const int rowCounts[] = { 100, 200, 1000 };
+	dl::DetectionParameters params;
+	params.confidenceThreshold = 0.5f;
+	dl::SsdOutputDecoder decoder;
+	decoder.SetDetectionParameters(params);
+
+	const cv::Size inputSize(300, 300);
+	const double ratio = std::min(static_cast<double>(frame.cols) / inputSize.width, static_cast<double>(frame.rows) / inputSize.height);
+	const cv::Size scaledInputSize(static_cast<int>(frame.cols / ratio), static_cast<int>(frame.rows / ratio));
+	const auto mapping = dl::Detector::CreateInputMapping(frame.size(), scaledInputSize);
+
+	std::cout << std::endl << "Decoding of a synthetic detection_out tensor, " << iterations << " iterations" << std::endl;
+	std::cout << std::left << std::setw(12) << "rows" << std::setw(16) << "feature map" << std::setw(16) << "decoder"
+		<< std::setw(10) << "speedup" << std::setw(12) << "boxes" << std::endl;
+	for (int rows : rowCounts) {
+		// [1, 1, rows, 7] with random confidences and boxes inside the unit square
+		int shape[] = { 1, 1, rows, 7 };
+		cv::Mat detection(4, shape, CV_32F);
+		cv::RNG rng(rows);
+		float* data = detection.ptr<float>();
+		for (int i = 0; i < rows; ++i) {
+			float* row = data + i * 7;
+			float x0 = rng.uniform(0.0f, 1.0f), x1 = rng.uniform(0.0f, 1.0f);
+			float y0 = rng.uniform(0.0f, 1.0f), y1 = rng.uniform(0.0f, 1.0f);
+			row[0] = 0.0f;
+			row[1] = static_cast<float>(rng.uniform(1, 91));
+			row[2] = rng.uniform(0.0f, 1.0f);
+			row[3] = std::min(x0, x1);
+			row[4] = std::min(y0, y1);
+			row[5] = std::max(x0, x1);
+			row[6] = std::max(y0, y1);
+		}
+		std::vector<cv::Mat> outs = { detection };
+
+		std::vector<dl::Detection> referenceDetections;
+		std::vector<dl::DetectionResult> results(1);
+		auto referenceMs = MeasureMs(iterations, [&]() {
+			DecodeWithFeatureMap(detection, params, scaledInputSize, ratio, frame.size(), referenceDetections);
+		});
+		auto decoderMs = MeasureMs(iterations, [&]() {
+			results.front().detections.clear();
+			decoder.Decode(outs, { mapping }, results, std::nullopt, params.confidenceThreshold);
+		});
+		std::cout << std::left << std::setw(12) << rows << std::setw(16) << referenceMs << std::setw(16) << decoderMs
+			<< std::setw(10) << referenceMs / decoderMs << std::setw(12) << results.front().detections.size() << std::endl;
+	}
+}
+
+void BenchmarkYoloDecoding(const cv::Mat& frame, int iterations) {
+	// grids of a 640x640 YOLOv5 export with 80 classes and a smaller 320x320 one
+	const int rowCounts[] = { 6300, 25200 };
+	const int cols = 85;
+	dl::DetectionParameters params;
+	params.outputLayout = dl::OutputLayout::YOLO;
+	params.confidenceThreshold = 0.5f;
+	dl::YoloOutputDecoder decoder;
+	decoder.SetDetectionParameters(params);
+
+	std::cout << std::endl << "Decoding of a synthetic YOLO grid, " << iterations << " iterations, " << cv::getNumThreads() << " threads" << std::endl;
+	std::cout << std::left << std::setw(12) << "rows" << std::setw(16) << "1 thread" << std::setw(16) << "parallel"
+		<< std::setw(10) << "speedup" << std::setw(12) << "boxes" << std::endl;
+	for (int rows : rowCounts) {
+		const cv::Size inputSize(rows == 25200 ? 640 : 320, rows == 25200 ? 640 : 320);
+		const auto mapping = dl::Detector::CreateInputMapping(frame.size(), inputSize);
+		int shape[] = { 1, rows, cols };
+		cv::Mat grid(3, shape, CV_32F);
+		cv::RNG rng(rows);
+		float* data = grid.ptr<float>();
+		for (int i = 0; i < rows; ++i) {
+			float* row = data + static_cast<size_t>(i) * cols;
+			row[0] = rng.uniform(0.0f, static_cast<float>(inputSize.width));
+			row[1] = rng.uniform(0.0f, static_cast<float>(inputSize.height));
+			row[2] = rng.uniform(8.0f, 160.0f);
+			row[3] = rng.uniform(8.0f, 160.0f);
+			// most cells of a real grid are background
+			row[4] = rng.uniform(0.0f, 1.0f) < 0.02f ? rng.uniform(0.5f, 1.0f) : rng.uniform(0.0f, 0.1f);
+			for (int c = 5; c < cols; ++c)
+				row[c] = rng.uniform(0.0f, 1.0f);
+		}
+		std::vector<cv::Mat> outs = { grid };
+		std::vector<dl::DetectionResult> results(1);
+		auto decode = [&]() {
+			results.front().detections.clear();
+			decoder.Decode(outs, { mapping }, results, std::nullopt, params.confidenceThreshold);
+		};
+
+		const int threads = cv::getNumThreads();
+		cv::setNumThreads(1);
+		auto singleMs = MeasureMs(iterations, decode);
+		cv::setNumThreads(threads);
+		auto parallelMs = MeasureMs(iterations, decode);
+		std::cout << std::left << std::setw(12) << rows << std::setw(16) << singleMs << std::setw(16) << parallelMs
+			<< std::setw(10) << singleMs / parallelMs << std::setw(12) << results.front().detections.size() << std::endl;
+	}
+}
+
+void BenchmarkNms(const cv::Mat& frame, int iterations) {
+	const int boxCounts[] = { 100, 1000, 5000 };
+	dl::NmsParameters params;
+	params.mode = dl::NmsMode::HARD;
+	params.perClass = false;
+	params.iouThreshold = 0.45f;
+
+	std::cout << std::endl << "Non-maximum suppression of clustered random boxes, " << iterations << " iterations" << std::endl;
+	std::cout << std::left << std::setw(12) << "boxes" << std::setw(16) << "NMSBoxes" << std::setw(16) << "sorted index"
+		<< std::setw(10) << "speedup" << std::setw(12) << "kept" << std::setw(12) << "kept ref" << std::endl;
+	for (int boxCount : boxCounts) {
+		// boxes jitter around a few centers like the raw output of a detector does
+		cv::RNG rng(boxCount);
+		std::vector<dl::Detection> detections(boxCount);
+		std::vector<cv::Rect> boxes(boxCount);
+		std::vector<float> scores(boxCount);
+		for (int i = 0; i < boxCount; ++i) {
+			int centerX = (i % 16) * frame.cols / 16 + frame.cols / 32;
+			int centerY = ((i / 16) % 9) * frame.rows / 9 + frame.rows / 18;
+			int width = rng.uniform(30, 90);
+			int height = rng.uniform(30, 90);
+			boxes[i] = cv::Rect(centerX + rng.uniform(-10, 10) - width / 2, centerY + rng.uniform(-10, 10) - height / 2, width, height);
+			scores[i] = rng.uniform(0.5f, 1.0f);
+			detections[i].bbox = boxes[i];
+			detections[i].confidence = scores[i];
+			detections[i].classId = 1;
+		}
+
+		std::vector<int> indices;
+		std::vector<dl::Detection> suppressed;
+		auto referenceMs = MeasureMs(iterations, [&]() {
+			cv::dnn::NMSBoxes(boxes, scores, 0.0f, params.iouThreshold, indices);
+		});
+		// includes copying the detections since Apply works in place
+		auto nmsMs = MeasureMs(iterations, [&]() {
+			suppressed = detections;
+			dl::NonMaximumSuppression::Apply(suppressed, params);
+		});
+		std::cout << std::left << std::setw(12) << boxCount << std::setw(16) << referenceMs << std::setw(16) << nmsMs
+			<< std::setw(10) << referenceMs / nmsMs << std::setw(12) << suppressed.size() << std::setw(12) << indices.size() << std::endl;
+	}
+}
+
+void BenchmarkMasks(const cv::Mat& frame, int iterations) {
+	const int maskCounts[] = { 5, 20, 50 };
+	std::cout << std::endl << "Mask postprocessing and blending of 15x15 masks, " << iterations << " iterations" << std::endl;
+	std::cout << std::left << std::setw(12) << "masks" << std::setw(16) << "resize+copyTo" << std::setw(16) << "fused"
+		<< std::setw(10) << "speedup" << std::setw(16) << "max diff" << std::endl;
+	for (int maskCount : maskCounts) {
+		cv::RNG rng(maskCount);
+		std::vector<cv::Mat> lowResMasks(maskCount);
+		std::vector<cv::Rect> boxes(maskCount);
+		for (int i = 0; i < maskCount; ++i) {
+			lowResMasks[i].create(15, 15, CV_32F);
+			cv::randu(lowResMasks[i], cv::Scalar::all(0.0), cv::Scalar::all(1.0));
+			int width = rng.uniform(60, frame.cols / 3);
+			int height = rng.uniform(60, frame.rows / 3);
+			boxes[i] = cv::Rect(rng.uniform(0, frame.cols - width), rng.uniform(0, frame.rows - height), width, height);
+		}
+		const cv::Scalar color(0, 128, 255);
+
+		// what instance segmentation did before: resize, threshold, blend the roi and copy it back through the mask
+		cv::Mat reference;
+		auto referenceMs = MeasureMs(iterations, [&]() {
+			frame.copyTo(reference);
+			for (int i = 0; i < maskCount; ++i) {
+				cv::Mat objectMask;
+				cv::resize(lowResMasks[i], objectMask, boxes[i].size());
+				cv::Mat mask = (objectMask > 0.5f);
+				cv::Mat coloredRoi = (0.3 * color + 0.7 * reference(boxes[i]));
+				coloredRoi.convertTo(coloredRoi, CV_8UC3);
+				coloredRoi.copyTo(reference(boxes[i]), mask);
+			}
+		});
+		cv::Mat fused;
+		auto fusedMs = MeasureMs(iterations, [&]() {
+			frame.copyTo(fused);
+			cv::Mat mask;
+			for (int i = 0; i < maskCount; ++i) {
+				dl::MaskProcessor::Binarize(lowResMasks[i], boxes[i].size(), 0.5f, mask);
+				dl::MaskProcessor::Blend(fused, boxes[i], mask, color);
+			}
+		});
+		// rounding of the blend and pixels right at the threshold may differ by a little
+		double maxDiff = cv::norm(reference, fused, cv::NORM_INF);
+		std::cout << std::left << std::setw(12) << maskCount << std::setw(16) << referenceMs << std::setw(16) << fusedMs
+			<< std::setw(10) << referenceMs / fusedMs << std::setw(16) << maxDiff << std::endl;
+	}
+}
+
+int main(int argc, char** argv) {
+	cxxopts::Options options("Object Detection Benchmark");
+	options.add_options()
+		("width", "Width of the synthetic input frame", cxxopts::value<int>()->default_value("1280"))
+		("height", "Height of the synthetic input frame", cxxopts::value<int>()->default_value("720"))
+		("iterations", "Number of measured iterations", cxxopts::value<int>()->default_value("200"))
+		("h,help", "Print usage");
+
+	auto result = options.parse(argc, argv);
+	if (result.count("help")) {
+		std::cout << options.help() << std::endl;
+		exit(0);
+	}
+
+	cv::Mat frame(result["height"].as<int>(), result["width"].as<int>(), CV_8UC3);
+	cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(255));
+
+	BenchmarkPreprocessing(frame, result["iterations"].as<int>());
+	BenchmarkDecoding(frame, result["iterations"].as<int>());
+	BenchmarkYoloDecoding(frame, result["iterations"].as<int>());
+	BenchmarkNms(frame, result["iterations"].as<int>());
+	BenchmarkMasks(frame, result["iterations"].as<int>());
+
+	return 0;
+}
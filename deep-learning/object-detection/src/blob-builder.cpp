@@ -0,0 +1,162 @@
+#include <opencv2/core.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+#include <opencv2/dnn.hpp>
+#include <algorithm>
+#include <cmath>
+
+#include "object-detection/blob-builder.h"
+
+namespace dl {
+
+void
+BlobBuilder::CreateBlob(const std::vector<cv::Mat>& images, cv::Size size, double scaleFactor, const cv::Scalar& meanValues,
+	bool swapRB, cv::Mat& blob) {
+	// the fused path only covers the 8-bit bgr frames we get from cameras and files
+	bool fusable = !images.empty();
+	for (const auto& image : images) {
+		if (image.type() != CV_8UC3)
+			fusable = false;
+	}
+	if (!fusable) {
+		blob = cv::dnn::blobFromImages(images, scaleFactor, size, meanValues, swapRB, false);
+		return;
+	}
+
+	int blobSizes[] = { static_cast<int>(images.size()), 3, size.height, size.width };
+	blob.create(4, blobSizes, CV_32F);
+	for (size_t i = 0; i < images.size(); ++i) {
+		FillBlob(images[i], size, scaleFactor, meanValues, swapRB, blob.ptr<float>(static_cast<int>(i)));
+	}
+}
+
+cv::Mat
+BlobBuilder::SliceBlob(const cv::Mat& blob, int index) {
+	int sliceSizes[] = { 1, blob.size[1], blob.size[2], blob.size[3] };
+	return cv::Mat(4, sliceSizes, CV_32F, const_cast<float*>(blob.ptr<float>(index)));
+}
+
+void
+BlobBuilder::FillBlob(const cv::Mat& image, cv::Size size, double scaleFactor, const cv::Scalar& meanValues, bool swapRB, float* blobData) {
+	const int srcWidth = image.cols;
+	const int srcHeight = image.rows;
+	const int dstWidth = size.width;
+	const int dstHeight = size.height;
+	const double scaleX = static_cast<double>(srcWidth) / dstWidth;
+	const double scaleY = static_cast<double>(srcHeight) / dstHeight;
+
+	// bilinear sampling with pixel centers aligned like cv::resize INTER_LINEAR
+	auto SourceCoordinate = [](int dst, double scale, int srcSize, int& src0, int& src1, float& weight) {
+		double f = (dst + 0.5) * scale - 0.5;
+		int s = static_cast<int>(std::floor(f));
+		weight = static_cast<float>(f - s);
+		if (s < 0) {
+			s = 0;
+			weight = 0.0f;
+		}
+		if (s >= srcSize - 1) {
+			s = srcSize - 1;
+			weight = 0.0f;
+		}
+		src0 = s;
+		src1 = std::min(s + 1, srcSize - 1);
+	};
+
+	std::vector<int> xOffsets(dstWidth * 2);
+	std::vector<float> xWeights(dstWidth);
+	for (int x = 0; x < dstWidth; ++x) {
+		int x0, x1;
+		SourceCoordinate(x, scaleX, srcWidth, x0, x1, xWeights[x]);
+		xOffsets[2 * x] = x0 * 3;
+		xOffsets[2 * x + 1] = x1 * 3;
+	}
+
+	// output plane c holds source channel order[c], the mean is given in output channel order like blobFromImage
+	const int order[3] = { swapRB ? 2 : 0, 1, swapRB ? 0 : 2 };
+	const float scale = static_cast<float>(scaleFactor);
+	const float bias[3] = {
+		static_cast<float>(-meanValues[0] * scaleFactor),
+		static_cast<float>(-meanValues[1] * scaleFactor),
+		static_cast<float>(-meanValues[2] * scaleFactor)
+	};
+	float* planes[3];
+	for (int c = 0; c < 3; ++c)
+		planes[order[c]] = blobData + static_cast<size_t>(c) * dstHeight * dstWidth;
+	float biasBySource[3];
+	for (int c = 0; c < 3; ++c)
+		biasBySource[order[c]] = bias[c];
+
+	// horizontally interpolated source rows, neighbouring output rows mostly share them
+	std::vector<float> rowBuffer(static_cast<size_t>(dstWidth) * 3 * 2);
+	float* row0 = rowBuffer.data();
+	float* row1 = row0 + dstWidth * 3;
+	int cachedY0 = -1;
+	int cachedY1 = -1;
+	auto InterpolateRow = [&](int y, float* dst) {
+		const uchar* src = image.ptr<uchar>(y);
+		for (int x = 0; x < dstWidth; ++x) {
+			const uchar* p0 = src + xOffsets[2 * x];
+			const uchar* p1 = src + xOffsets[2 * x + 1];
+			float w = xWeights[x];
+			dst[3 * x] = p0[0] + (p1[0] - p0[0]) * w;
+			dst[3 * x + 1] = p0[1] + (p1[1] - p0[1]) * w;
+			dst[3 * x + 2] = p0[2] + (p1[2] - p0[2]) * w;
+		}
+	};
+
+	for (int y = 0; y < dstHeight; ++y) {
+		int y0, y1;
+		float wy;
+		SourceCoordinate(y, scaleY, srcHeight, y0, y1, wy);
+		if (y0 != cachedY0) {
+			if (y0 == cachedY1) {
+				std::swap(row0, row1);
+				cachedY0 = cachedY1;
+				cachedY1 = -1;
+			}
+			else {
+				InterpolateRow(y0, row0);
+				cachedY0 = y0;
+			}
+		}
+		if (y1 != cachedY1) {
+			InterpolateRow(y1, row1);
+			cachedY1 = y1;
+		}
+
+		float* dst0 = planes[0] + static_cast<size_t>(y) * dstWidth;
+		float* dst1 = planes[1] + static_cast<size_t>(y) * dstWidth;
+		float* dst2 = planes[2] + static_cast<size_t>(y) * dstWidth;
+		int x = 0;
+#if CV_SIMD
+		// vertical interpolation, mean, scale and channel split, nlanes pixels per iteration
+		const cv::v_float32 vWeight = cv::vx_setall_f32(wy);
+		const cv::v_float32 vScale = cv::vx_setall_f32(scale);
+		const cv::v_float32 vBias0 = cv::vx_setall_f32(biasBySource[0]);
+		const cv::v_float32 vBias1 = cv::vx_setall_f32(biasBySource[1]);
+		const cv::v_float32 vBias2 = cv::vx_setall_f32(biasBySource[2]);
+		const int lanes = cv::v_float32::nlanes;
+		for (; x <= dstWidth - lanes; x += lanes) {
+			cv::v_float32 a0, a1, a2, b0, b1, b2;
+			cv::v_load_deinterleave(row0 + 3 * x, a0, a1, a2);
+			cv::v_load_deinterleave(row1 + 3 * x, b0, b1, b2);
+			a0 = cv::v_fma(b0 - a0, vWeight, a0);
+			a1 = cv::v_fma(b1 - a1, vWeight, a1);
+			a2 = cv::v_fma(b2 - a2, vWeight, a2);
+			cv::v_store(dst0 + x, cv::v_fma(a0, vScale, vBias0));
+			cv::v_store(dst1 + x, cv::v_fma(a1, vScale, vBias1));
+			cv::v_store(dst2 + x, cv::v_fma(a2, vScale, vBias2));
+		}
+		cv::vx_cleanup();
+#endif
+		for (; x < dstWidth; ++x) {
+			float v0 = row0[3 * x] + (row1[3 * x] - row0[3 * x]) * wy;
+			float v1 = row0[3 * x + 1] + (row1[3 * x + 1] - row0[3 * x + 1]) * wy;
+			float v2 = row0[3 * x + 2] + (row1[3 * x + 2] - row0[3 * x + 2]) * wy;
+			dst0[x] = v0 * scale + biasBySource[0];
+			dst1[x] = v1 * scale + biasBySource[1];
+			dst2[x] = v2 * scale + biasBySource[2];
+		}
+	}
+}
+
+}
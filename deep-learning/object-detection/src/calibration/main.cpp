@@ -0,0 +1,163 @@
+#include <object-detection/object-detection.h>
+#include <object-detection/backend-selector.h>
+#include <object-detection/model-registry.h>
+#include <object-detection/non-maximum-suppression.h>
+#include <cxxopts.hpp>
+#include <file/file.h>
+#include <string/string.h>
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <iomanip>
+#include <iostream>
+
+struct ProfileReport {
+	dl::Precision precision;
+	double meanLatencyMs = 0.0;
+	double throughput = 0.0;
+	// IoU of every reference box with its best match of the profile, missing boxes count as 0
+	double meanIoU = 1.0;
+	size_t boxes = 0;
+	size_t referenceBoxes = 0;
+};
+
+dl::Precision ConvertStringToPrecision(const std::string& precision) {
+	if (precision == "fp16")
+		return dl::Precision::FP16;
+	if (precision == "int8")
+		return dl::Precision::INT8;
+	return dl::Precision::FP32;
+}
+
+dl::NetworkType ConvertStringToNetworkType(const std::string& type) {
+	if (type == "tensorflow")
+		return dl::NetworkType::TENSORFLOW;
+	if (type == "onnx")
+		return dl::NetworkType::ONNX;
+	return dl::NetworkType::CAFFE;
+}
+
+std::vector<std::vector<dl::Detection>> RunProfile(const dl::NetworkProperties& properties, const dl::DetectionParameters& params,
+	const std::vector<cv::Mat>& images, ProfileReport& report) {
+	dl::Detector detector(properties);
+	detector.SetDetectionParameters(params);
+	// the first image initializes the backend and is not measured
+	detector.Detect(images.front(), std::nullopt);
+
+	std::vector<std::vector<dl::Detection>> retVal;
+	cv::TickMeter timer;
+	for (const auto& image : images) {
+		timer.start();
+		auto result = detector.Detect(image, std::nullopt);
+		timer.stop();
+		report.boxes += result.detections.size();
+		retVal.emplace_back(std::move(result.detections));
+	}
+	report.meanLatencyMs = timer.getTimeMilli() / images.size();
+	report.throughput = images.size() / timer.getTimeSec();
+	return retVal;
+}
+
+double CompareDetections(const std::vector<std::vector<dl::Detection>>& reference, const std::vector<std::vector<dl::Detection>>& detections,
+	size_t& referenceBoxes) {
+	double iouSum = 0.0;
+	referenceBoxes = 0;
+	for (size_t i = 0; i < reference.size(); ++i) {
+		for (const auto& referenceDetection : reference[i]) {
+			float bestIoU = 0.0f;
+			for (const auto& det : detections[i]) {
+				if (det.classId == referenceDetection.classId)
+					bestIoU = std::max(bestIoU, dl::NonMaximumSuppression::IntersectionOverUnion(referenceDetection.bbox, det.bbox));
+			}
+			iouSum += bestIoU;
+			++referenceBoxes;
+		}
+	}
+	return referenceBoxes > 0 ? iouSum / referenceBoxes : 1.0;
+}
+
+int main(int argc, char** argv) {
+	cxxopts::Options options("Object Detection Calibration");
+	options.add_options()
+		("images", "Folder of calibration images", cxxopts::value<std::string>()->default_value(dl::ModelRegistry::Resolve("deep-learning/face-detection/resource")))
+		("type", "Network type of the model (caffe, tensorflow, onnx)", cxxopts::value<std::string>()->default_value("caffe"))
+		("config", "Config file of the model", cxxopts::value<std::string>()->default_value(
+			dl::ModelRegistry::Resolve("deep-learning/face-detection/resource/face/caffe/300x300/deploy.prototxt")))
+		("weights", "Weight file of the model", cxxopts::value<std::string>()->default_value(
+			dl::ModelRegistry::Resolve("deep-learning/face-detection/resource/face/caffe/300x300/res10_300x300_ssd_iter_140000_fp16.caffemodel")))
+		("int8-weights", "Quantized ONNX export of the model for the int8 profile", cxxopts::value<std::string>()->default_value(""))
+		("width", "Network input width", cxxopts::value<int>()->default_value("300"))
+		("height", "Network input height", cxxopts::value<int>()->default_value("300"))
+		("threshold", "Confidence threshold", cxxopts::value<float>()->default_value("0.5"))
+		("profiles", "Comma separated precision profiles compared with fp32 (fp16, int8)", cxxopts::value<std::string>()->default_value("fp16,int8"))
+		("h,help", "Print usage");
+
+	auto result = options.parse(argc, argv);
+	if (result.count("help")) {
+		std::cout << options.help() << std::endl;
+		exit(0);
+	}
+
+	// images are resized to the network input once so that every profile sees the same pixels
+	auto imageFolder = result["images"].as<std::string>();
+	if (!base::File::DirectoryExists(imageFolder)) {
+		std::cout << "Image folder does not exist" << std::endl;
+		return -1;
+	}
+	const cv::Size inputSize(result["width"].as<int>(), result["height"].as<int>());
+	std::vector<cv::Mat> images;
+	for (auto& file : base::File::GetFilesWithExtension(imageFolder)) {
+		auto ext = base::File::GetFileExtension(file.first);
+		if (ext != ".jpg" && ext != ".jpeg" && ext != ".png" && ext != ".bmp")
+			continue;
+		cv::Mat image = cv::imread(file.first);
+		if (image.empty())
+			continue;
+		cv::resize(image, image, inputSize);
+		images.emplace_back(std::move(image));
+	}
+	if (images.empty()) {
+		std::cout << "No images found in " << imageFolder << std::endl;
+		return -1;
+	}
+
+	dl::NetworkProperties properties;
+	properties.networkType = ConvertStringToNetworkType(result["type"].as<std::string>());
+	properties.configFilePath = result["config"].as<std::string>();
+	properties.weightFilePath = result["weights"].as<std::string>();
+	properties.int8WeightFilePath = result["int8-weights"].as<std::string>();
+	properties.imageInputWidth = inputSize.width;
+	properties.imageInputHeight = inputSize.height;
+	dl::DetectionParameters params;
+	params.confidenceThreshold = result["threshold"].as<float>();
+
+	std::vector<ProfileReport> reports(1);
+	reports.front().precision = dl::Precision::FP32;
+	auto reference = RunProfile(properties, params, images, reports.front());
+	for (const auto& profile : base::String::SplitString(result["profiles"].as<std::string>(), ",")) {
+		ProfileReport report;
+		report.precision = ConvertStringToPrecision(profile);
+		if (report.precision == dl::Precision::FP32)
+			continue;
+		if (report.precision == dl::Precision::INT8 && properties.int8WeightFilePath.empty()) {
+			std::cout << "Skipping int8, no quantized model given" << std::endl;
+			continue;
+		}
+		auto profileProperties = properties;
+		profileProperties.precision = report.precision;
+		auto detections = RunProfile(profileProperties, params, images, report);
+		report.meanIoU = CompareDetections(reference, detections, report.referenceBoxes);
+		reports.push_back(report);
+	}
+
+	std::cout << images.size() << " images of " << properties.weightFilePath << std::endl;
+	std::cout << std::left << std::setw(10) << "profile" << std::setw(14) << "latency ms" << std::setw(14) << "images/s"
+		<< std::setw(10) << "boxes" << std::setw(12) << "mean IoU" << std::setw(12) << "IoU delta" << std::endl;
+	for (const auto& report : reports) {
+		std::cout << std::left << std::setw(10) << dl::BackendSelector::ConvertPrecisionToString(report.precision)
+			<< std::setw(14) << report.meanLatencyMs << std::setw(14) << report.throughput << std::setw(10) << report.boxes
+			<< std::setw(12) << report.meanIoU << std::setw(12) << 1.0 - report.meanIoU << std::endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,71 @@
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include "object-detection/detection-renderer.h"
+#include "object-detection/mask-processor.h"
+
+namespace dl {
+
+void
+DetectionRenderer::Render(DetectionResult& result, RenderMode mode) {
+	if (mode == RenderMode::NONE || result.originalImage.empty())
+		return;
+
+	result.originalImage.copyTo(result.imageWithBbox);
+	for (const auto& det : result.detections) {
+		DrawDetection(result.imageWithBbox, det);
+	}
+
+	if (mode != RenderMode::BOXES_AND_MASKS && mode != RenderMode::BOXES_MASKS_AND_CONTOURS)
+		return;
+
+	bool hasMask = false;
+	for (auto& det : result.detections) {
+		if (!det.drawingElement.has_value())
+			continue;
+		if (!hasMask) {
+			result.imageWithBbox.copyTo(result.imageWithBboxAndMasks);
+			hasMask = true;
+		}
+		DrawMask(result.imageWithBboxAndMasks, det.drawingElement.value(), mode == RenderMode::BOXES_MASKS_AND_CONTOURS);
+	}
+}
+
+void
+DetectionRenderer::DrawDetection(cv::Mat& image, const Detection& det) {
+	cv::rectangle(image, det.bbox, cv::Scalar(0, 255, 0), 1, 8, 0);
+	if (det.objectClassString.has_value()) {
+		cv::Point textPoint = cv::Point(det.bbox.x, det.bbox.y);
+		cv::putText(image, det.objectClassString.value(), textPoint, 1, 1, cv::Scalar(255, 0, 0));
+	}
+	cv::Point textPoint = cv::Point(det.bbox.x, det.bbox.y + 15);
+	cv::putText(image, std::to_string(det.confidence), textPoint, 1, 1, cv::Scalar(255, 0, 0));
+	if (det.ageEstimation.has_value()) {
+		textPoint = cv::Point(det.bbox.x, det.bbox.y + 30);
+		cv::putText(image, "Age: " + std::string(det.ageEstimation.value().label), textPoint, 1, 1, cv::Scalar(255, 0, 0));
+	}
+	if (det.genderEstimation.has_value()) {
+		textPoint = cv::Point(det.bbox.x, det.bbox.y + 45);
+		cv::putText(image, "Gender: " + std::string(det.genderEstimation.value().label), textPoint, 1, 1, cv::Scalar(255, 0, 0));
+	}
+	if (det.ethnicityEstimation.has_value()) {
+		textPoint = cv::Point(det.bbox.x, det.bbox.y + 60);
+		cv::putText(image, "Ethnicity: " + std::string(det.ethnicityEstimation.value().label), textPoint, 1, 1, cv::Scalar(255, 0, 0));
+	}
+}
+
+void
+DetectionRenderer::DrawMask(cv::Mat& image, const SegmentationDrawingElement& element, bool contours) {
+	// masks that were not encoded by postprocessing can not be placed
+	if (element.mask.Empty())
+		return;
+	MaskProcessor::Blend(image, element.mask, element.color);
+	if (contours) {
+		// contour tracing needs the pixels, decode into a per thread roi buffer
+		thread_local cv::Mat roi;
+		element.mask.Decode(roi);
+		MaskProcessor::DrawContours(image, element.mask.GetBbox(), roi, element.color);
+	}
+}
+
+}
@@ -0,0 +1,100 @@
+#include <logger/logger.h>
+#include <assertion/assertion.h>
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <thread>
+
+#include "object-detection/detector-pool.h"
+#include "object-detection/model-registry.h"
+
+std::shared_ptr<base::Logger> dl::DetectorPool::m_logger = std::make_shared<base::Logger>();
+
+namespace dl {
+
+DetectorPool::DetectorPool(const NetworkProperties& properties, size_t maxSize)
+	: m_networkProperties(ModelRegistry::ResolvePrecision(properties)) {
+	SetMaxSize(maxSize);
+	m_model = ModelRegistry::GetModel(m_networkProperties);
+	if (!m_model) {
+		// the detectors are created without a network and report the failure themselves
+		std::string logMsg = "Detector pool of " + m_networkProperties.weightFilePath + " has no model";
+		m_logger->LogError(logMsg.c_str());
+		m_model = std::make_shared<const ModelBuffer>();
+	}
+	// the prototype selects the backend once, clones reuse its choice
+	m_prototype = std::make_shared<Detector>(m_networkProperties, *m_model);
+	m_detectors.push_back(m_prototype);
+	m_idleDetectors.push_back(m_prototype);
+}
+
+DetectorPool::Lease
+DetectorPool::Acquire() {
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		// a failed creation frees its slot again, so waiters also wake up when the pool may grow
+		m_detectorReleased.wait(lock, [this]() { return !m_idleDetectors.empty() || m_detectors.size() + m_pendingDetectors < m_maxSize; });
+		if (!m_idleDetectors.empty()) {
+			auto detector = m_idleDetectors.back();
+			m_idleDetectors.pop_back();
+			return Lease(shared_from_this(), detector);
+		}
+		++m_pendingDetectors;
+	}
+
+	// creating a network takes a while, other callers can still lease idle detectors meanwhile
+	std::shared_ptr<Detector> detector;
+	try {
+		detector = std::make_shared<Detector>(m_networkProperties, *m_model, m_prototype->GetBackendChoice());
+	}
+	catch (...) {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			--m_pendingDetectors;
+		}
+		m_detectorReleased.notify_one();
+		throw;
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_detectors.push_back(detector);
+		--m_pendingDetectors;
+		std::string logMsg = "Detector pool of " + m_networkProperties.weightFilePath + " grew to " + std::to_string(m_detectors.size()) + " networks";
+		m_logger->LogInfo(logMsg.c_str());
+	}
+	return Lease(shared_from_this(), detector);
+}
+
+void
+DetectorPool::Release(std::shared_ptr<Detector> detector) {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_idleDetectors.push_back(detector);
+	}
+	m_detectorReleased.notify_one();
+}
+
+void
+DetectorPool::SetMaxSize(size_t maxSize) {
+	if (maxSize == 0)
+		maxSize = std::max(1u, std::thread::hardware_concurrency());
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_maxSize = maxSize;
+	}
+	// a larger pool lets waiting callers create their own detector
+	m_detectorReleased.notify_all();
+}
+
+size_t
+DetectorPool::GetSize() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_detectors.size();
+}
+
+size_t
+DetectorPool::GetMaxSize() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_maxSize;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include <logger/logger.h>
+#include <assertion/assertion.h>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "object-detection/mask-processor.h"
+
+namespace dl {
+
+void
+MaskProcessor::Binarize(const cv::Mat& lowResMask, cv::Size size, float threshold, cv::Mat& mask) {
+	ASSERT((lowResMask.type() == CV_32F && lowResMask.dims == 2), "Segmentation mask must be a 2D float matrix", base::Logger::Severity::Error);
+	mask.create(size, CV_8U);
+	if (size.width <= 0 || size.height <= 0 || lowResMask.empty())
+		return;
+
+	const int srcWidth = lowResMask.cols;
+	const int srcHeight = lowResMask.rows;
+	// per thread arena, source columns and weights of every output column plus the horizontally interpolated source
+	// rows, the masks are tiny (15x15 for mask rcnn) so this is a few bbox widths of floats and is reused across calls
+	thread_local std::vector<int> xOffsets;
+	thread_local std::vector<float> xWeights;
+	thread_local std::vector<float> rows;
+	xOffsets.resize(size.width);
+	xWeights.resize(size.width);
+	rows.resize(static_cast<size_t>(srcHeight) * size.width);
+
+	// same sampling grid as cv::resize with INTER_LINEAR
+	const float scaleX = static_cast<float>(srcWidth) / size.width;
+	for (int x = 0; x < size.width; ++x) {
+		float fx = (x + 0.5f) * scaleX - 0.5f;
+		int x0 = static_cast<int>(std::floor(fx));
+		float w = fx - x0;
+		if (x0 < 0) {
+			x0 = 0;
+			w = 0.0f;
+		}
+		if (x0 >= srcWidth - 1) {
+			x0 = srcWidth - 1;
+			w = 0.0f;
+		}
+		xOffsets[x] = x0;
+		xWeights[x] = w;
+	}
+
+	// horizontal pass once per source row instead of once per output row
+	for (int y = 0; y < srcHeight; ++y) {
+		const float* src = lowResMask.ptr<float>(y);
+		float* dst = rows.data() + static_cast<size_t>(y) * size.width;
+		for (int x = 0; x < size.width; ++x) {
+			const int x0 = xOffsets[x];
+			const int x1 = std::min(x0 + 1, srcWidth - 1);
+			dst[x] = src[x0] + (src[x1] - src[x0]) * xWeights[x];
+		}
+	}
+
+	// vertical pass fused with the threshold
+	const float scaleY = static_cast<float>(srcHeight) / size.height;
+	for (int y = 0; y < size.height; ++y) {
+		float fy = (y + 0.5f) * scaleY - 0.5f;
+		int y0 = static_cast<int>(std::floor(fy));
+		float w = fy - y0;
+		if (y0 < 0) {
+			y0 = 0;
+			w = 0.0f;
+		}
+		if (y0 >= srcHeight - 1) {
+			y0 = srcHeight - 1;
+			w = 0.0f;
+		}
+		const int y1 = std::min(y0 + 1, srcHeight - 1);
+		const float* top = rows.data() + static_cast<size_t>(y0) * size.width;
+		const float* bottom = rows.data() + static_cast<size_t>(y1) * size.width;
+		uchar* dst = mask.ptr<uchar>(y);
+		for (int x = 0; x < size.width; ++x) {
+			const float value = top[x] + (bottom[x] - top[x]) * w;
+			dst[x] = static_cast<uchar>(value > threshold ? 255 : 0);
+		}
+	}
+}
+
+void
+MaskProcessor::Blend(cv::Mat& image, const cv::Rect& bbox, const cv::Mat& mask, const cv::Scalar& color, float alpha) {
+	if (image.empty() || mask.empty())
+		return;
+	ASSERT((image.depth() == CV_8U && image.channels() <= 4), "Masks can only be blended into 8-bit images", base::Logger::Severity::Error);
+	ASSERT((mask.type() == CV_8U && mask.size() == bbox.size()), "Mask must be a CV_8U matrix of the bbox size", base::Logger::Severity::Error);
+
+	// only the part of the bbox inside the image is painted, mask coordinates are shifted accordingly
+	const cv::Rect area = bbox & cv::Rect(0, 0, image.cols, image.rows);
+	if (area.empty())
+		return;
+	const int channels = image.channels();
+	float weightedColor[4];
+	for (int c = 0; c < channels; ++c)
+		weightedColor[c] = alpha * static_cast<float>(color[c]);
+	const float keep = 1.0f - alpha;
+
+	for (int y = area.y; y < area.y + area.height; ++y) {
+		const uchar* m = mask.ptr<uchar>(y - bbox.y) + (area.x - bbox.x);
+		uchar* p = image.ptr<uchar>(y) + static_cast<size_t>(area.x) * channels;
+		for (int x = 0; x < area.width; ++x, p += channels) {
+			if (!m[x])
+				continue;
+			for (int c = 0; c < channels; ++c)
+				p[c] = cv::saturate_cast<uchar>(weightedColor[c] + keep * p[c]);
+		}
+	}
+}
+
+void
+MaskProcessor::Blend(cv::Mat& image, const RleMask& mask, const cv::Scalar& color, float alpha) {
+	if (image.empty() || mask.Empty())
+		return;
+	ASSERT((image.depth() == CV_8U && image.channels() <= 4), "Masks can only be blended into 8-bit images", base::Logger::Severity::Error);
+
+	const int channels = image.channels();
+	float weightedColor[4];
+	for (int c = 0; c < channels; ++c)
+		weightedColor[c] = alpha * static_cast<float>(color[c]);
+	const float keep = 1.0f - alpha;
+	mask.ForEachInterval([&](int row, int begin, int end) {
+		if (row < 0 || row >= image.rows)
+			return;
+		begin = std::max(begin, 0);
+		end = std::min(end, image.cols);
+		uchar* p = image.ptr<uchar>(row) + static_cast<size_t>(begin) * channels;
+		for (int x = begin; x < end; ++x, p += channels) {
+			for (int c = 0; c < channels; ++c)
+				p[c] = cv::saturate_cast<uchar>(weightedColor[c] + keep * p[c]);
+		}
+	});
+}
+
+void
+MaskProcessor::DrawContours(cv::Mat& image, const cv::Rect& bbox, const cv::Mat& mask, const cv::Scalar& color, int thickness) {
+	if (image.empty() || mask.empty())
+		return;
+	std::vector<std::vector<cv::Point>> contours;
+	std::vector<cv::Vec4i> hierarchy;
+	cv::findContours(mask, contours, hierarchy, cv::RETR_CCOMP, cv::CHAIN_APPROX_SIMPLE);
+	// the offset places the contours at the bbox, drawContours clips everything outside of the image
+	cv::drawContours(image, contours, -1, color, thickness, cv::LINE_8, hierarchy, 100, bbox.tl());
+}
+
+}
\ No newline at end of file
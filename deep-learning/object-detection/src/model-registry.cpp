@@ -0,0 +1,231 @@
+#include <logger/logger.h>
+#include <assertion/assertion.h>
+#include <opencv2/core.hpp>
+#include <file/mapped-file.h>
+#include <filesystem>
+
+#include "object-detection/model-registry.h"
+#include "object-detection/detector-pool.h"
+
+std::string dl::ModelRegistry::m_root = "../../../../";
+std::map<std::string, std::string> dl::ModelRegistry::m_overrides;
+std::map<std::string, dl::ModelRegistry::Entry> dl::ModelRegistry::m_models;
+std::map<std::string, std::weak_ptr<dl::DetectorPool>> dl::ModelRegistry::m_pools;
+std::mutex dl::ModelRegistry::m_mutex;
+std::mutex dl::ModelRegistry::m_poolMutex;
+std::shared_ptr<base::Logger> dl::ModelRegistry::m_logger = std::make_shared<base::Logger>();
+
+namespace dl {
+
+void
+ModelRegistry::SetRoot(const std::string& root) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_root = root;
+	if (!m_root.empty() && m_root.back() != '/' && m_root.back() != '\\')
+		m_root += '/';
+}
+
+std::string
+ModelRegistry::GetRoot() {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_root;
+}
+
+bool
+ModelRegistry::LoadManifest(const std::string& manifestPath) {
+	cv::FileStorage fs(manifestPath, cv::FileStorage::READ);
+	if (!fs.isOpened()) {
+		std::string logMsg = "Model manifest " + manifestPath + " can not be opened";
+		m_logger->LogError(logMsg.c_str());
+		return false;
+	}
+
+	auto rootNode = fs["root"];
+	if (!rootNode.empty())
+		SetRoot(static_cast<std::string>(rootNode));
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (const auto& node : fs["models"]) {
+		std::string resource = static_cast<std::string>(node["resource"]);
+		std::string path = static_cast<std::string>(node["path"]);
+		if (!resource.empty() && !path.empty())
+			m_overrides[resource] = path;
+	}
+	std::string logMsg = "Model manifest " + manifestPath + " loaded with root " + m_root + " and " + std::to_string(m_overrides.size()) + " overrides";
+	m_logger->LogInfo(logMsg.c_str());
+	return true;
+}
+
+std::string
+ModelRegistry::Resolve(const std::string& resourcePath) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto it = m_overrides.find(resourcePath);
+	if (it != m_overrides.end())
+		return it->second;
+	return m_root + resourcePath;
+}
+
+std::string
+ModelRegistry::CreateKey(const NetworkProperties& properties) {
+	// different relative spellings of the same file end up in one entry
+	auto Normalize = [](const std::string& path) {
+		if (path.empty())
+			return path;
+		std::error_code error;
+		auto normalized = std::filesystem::weakly_canonical(path, error);
+		return error ? path : normalized.string();
+	};
+	return Normalize(properties.configFilePath) + "|" + Normalize(properties.weightFilePath);
+}
+
+NetworkProperties
+ModelRegistry::ResolvePrecision(const NetworkProperties& properties) {
+	NetworkProperties retVal = properties;
+	if (properties.precision != Precision::INT8)
+		return retVal;
+	if (properties.int8WeightFilePath.empty()) {
+		std::string logMsg = "No quantized model given for " + properties.weightFilePath + ", INT8 runs the original weights on the CPU";
+		m_logger->LogWarn(logMsg.c_str());
+		return retVal;
+	}
+	retVal.configFilePath = "";
+	retVal.weightFilePath = properties.int8WeightFilePath;
+	retVal.networkType = NetworkType::ONNX;
+	return retVal;
+}
+
+std::shared_ptr<const ModelBuffer>
+ModelRegistry::GetModel(const NetworkProperties& properties) {
+	// a missing file is a load failure of the model, not of the process
+	auto MapFile = [](const std::string& path, std::shared_ptr<const base::MappedFile>& mappedFile) {
+		if (path.empty())
+			return true;
+		auto file = std::make_shared<base::MappedFile>();
+		if (!file->Open(path)) {
+			std::string logMsg = "Model file " + path + " can not be mapped";
+			m_logger->LogError(logMsg.c_str());
+			return false;
+		}
+		mappedFile = file;
+		return true;
+	};
+
+	auto key = CreateKey(properties);
+	// the lock is held while mapping so that concurrent first users do not map the same file twice
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto& entry = m_models[key];
+	++entry.statistics.requestCount;
+	if (entry.model)
+		return entry.model;
+
+	cv::TickMeter timer;
+	timer.start();
+	auto model = std::make_shared<ModelBuffer>();
+	if (!MapFile(properties.configFilePath, model->configFile) || !MapFile(properties.weightFilePath, model->weightFile))
+		return nullptr;
+	timer.stop();
+	entry.model = model;
+	entry.statistics.weightFilePath = properties.weightFilePath;
+	entry.statistics.mappedBytes = (model->configFile ? model->configFile->Size() : 0) + (model->weightFile ? model->weightFile->Size() : 0);
+	entry.statistics.mapTimeMs += timer.getTimeMilli();
+	std::string logMsg = "Mapped " + properties.weightFilePath + " (" + std::to_string(entry.statistics.mappedBytes) +
+		" bytes) in " + std::to_string(timer.getTimeMilli()) + " ms";
+	m_logger->LogInfo(logMsg.c_str());
+	return entry.model;
+}
+
+cv::dnn::Net
+ModelRegistry::CreateNetwork(const NetworkProperties& properties) {
+	auto resolvedProperties = ResolvePrecision(properties);
+	auto model = GetModel(resolvedProperties);
+	if (!model)
+		return cv::dnn::Net();
+	return CreateNetwork(resolvedProperties, *model);
+}
+
+cv::dnn::Net
+ModelRegistry::CreateNetwork(const NetworkProperties& properties, const ModelBuffer& model) {
+	// the buffer overloads parse straight from the mapped pages, OpenCV copies the weights into every network
+	const char* configData = model.configFile ? model.configFile->Data() : nullptr;
+	size_t configSize = model.configFile ? model.configFile->Size() : 0;
+	const char* weightData = model.weightFile ? model.weightFile->Data() : nullptr;
+	size_t weightSize = model.weightFile ? model.weightFile->Size() : 0;
+	if (weightData == nullptr)
+		return cv::dnn::Net();
+
+	// parsing copies the weights out of the mapping, this is where a model really costs time and memory
+	cv::TickMeter timer;
+	timer.start();
+	cv::dnn::Net network;
+	switch (properties.networkType) {
+	case NetworkType::CAFFE: network = cv::dnn::readNetFromCaffe(configData, configSize, weightData, weightSize); break;
+	case NetworkType::TENSORFLOW: network = cv::dnn::readNetFromTensorflow(weightData, weightSize, configData, configSize); break;
+	case NetworkType::ONNX: network = cv::dnn::readNetFromONNX(weightData, weightSize); break;
+	default: break;
+	}
+	timer.stop();
+
+	auto key = CreateKey(properties);
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto& statistics = m_models[key].statistics;
+	if (statistics.weightFilePath.empty())
+		statistics.weightFilePath = properties.weightFilePath;
+	if (!network.empty())
+		++statistics.networkCount;
+	statistics.parseTimeMs += timer.getTimeMilli();
+	return network;
+}
+
+std::shared_ptr<DetectorPool>
+ModelRegistry::GetDetectorPool(const NetworkProperties& properties) {
+	// the backend is selected per pool, so the policy and precision are part of the key next to the input size
+	auto resolvedProperties = ResolvePrecision(properties);
+	auto key = CreateKey(resolvedProperties) + "|" + std::to_string(properties.imageInputWidth) + "x" + std::to_string(properties.imageInputHeight) +
+		"|" + std::to_string(static_cast<int>(properties.precision)) + "|" + std::to_string(static_cast<int>(properties.backendPolicy));
+	std::lock_guard<std::mutex> lock(m_poolMutex);
+	auto pool = m_pools[key].lock();
+	if (pool)
+		return pool;
+	pool = std::make_shared<DetectorPool>(properties);
+	m_pools[key] = pool;
+	return pool;
+}
+
+void
+ModelRegistry::ReleaseUnused() {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (auto& [key, entry] : m_models) {
+		if (entry.model && entry.model.use_count() == 1)
+			entry.model.reset();
+	}
+}
+
+std::vector<ModelStatistics>
+ModelRegistry::GetStatistics() {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::vector<ModelStatistics> retVal;
+	for (const auto& [key, entry] : m_models) {
+		retVal.push_back(entry.statistics);
+		retVal.back().resident = entry.model != nullptr;
+	}
+	return retVal;
+}
+
+void
+ModelRegistry::LogStatistics() {
+	size_t mappedBytes = 0;
+	size_t networkCount = 0;
+	for (const auto& statistics : GetStatistics()) {
+		if (statistics.resident)
+			mappedBytes += statistics.mappedBytes;
+		networkCount += statistics.networkCount;
+		std::string logMsg = statistics.weightFilePath + ": " + std::to_string(statistics.mappedBytes) + " bytes mapped in " +
+			std::to_string(statistics.mapTimeMs) + " ms, " + std::to_string(statistics.networkCount) + " networks parsed in " +
+			std::to_string(statistics.parseTimeMs) + " ms, requested " + std::to_string(statistics.requestCount) + " times" +
+			(statistics.resident ? "" : ", released");
+		m_logger->LogInfo(logMsg.c_str());
+	}
+	std::string logMsg = "Model files mapped: " + std::to_string(mappedBytes) + " bytes, networks parsed: " + std::to_string(networkCount);
+	m_logger->LogInfo(logMsg.c_str());
+}
+
+}
@@ -0,0 +1,117 @@
+#include <logger/logger.h>
+#include <assertion/assertion.h>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <sstream>
+
+#include "object-detection/motion-gate.h"
+
+std::shared_ptr<base::Logger> dl::MotionGate::m_logger = std::make_shared<base::Logger>();
+
+namespace dl {
+
+void
+MotionGate::SetParameters(const MotionGatingParameters& params) {
+	ASSERT((params.downscale >= 1), "Downscale of the motion gate must be at least 1", base::Logger::Severity::Error);
+	m_params = params;
+	Reset();
+}
+
+void
+MotionGate::Reset() {
+	m_background.release();
+}
+
+bool
+MotionGate::Update(const cv::Mat& frame, std::vector<cv::Rect>& regions) {
+	regions.clear();
+	const cv::Rect frameRect(0, 0, frame.cols, frame.rows);
+	const size_t framePixels = static_cast<size_t>(frameRect.area());
+	m_statistics.frames++;
+	m_statistics.pixels += framePixels;
+
+	// the comparison runs on a small gray copy, INTER_AREA averages the sensor noise away
+	const cv::Size smallSize(std::max(1, frame.cols / m_params.downscale), std::max(1, frame.rows / m_params.downscale));
+	cv::resize(frame, m_small, smallSize, 0, 0, cv::INTER_AREA);
+	if (m_small.channels() == 3)
+		cv::cvtColor(m_small, m_gray, cv::COLOR_BGR2GRAY);
+	else
+		m_gray = m_small;
+	m_gray.convertTo(m_gray, CV_32F);
+
+	// nothing to compare with, the whole frame has to be detected
+	if (m_background.empty() || m_background.size() != m_gray.size()) {
+		m_gray.copyTo(m_background);
+		regions.push_back(frameRect);
+		return true;
+	}
+
+	cv::absdiff(m_gray, m_background, m_difference);
+	cv::accumulateWeighted(m_gray, m_background, m_params.backgroundRate);
+	cv::threshold(m_difference, m_changed, m_params.pixelThreshold, 255.0, cv::THRESH_BINARY);
+	m_changed.convertTo(m_changed, CV_8U);
+
+	const int changedCells = cv::countNonZero(m_changed);
+	if (changedCells < m_params.minChangedFraction * m_changed.total()) {
+		m_statistics.skippedFrames++;
+		m_statistics.skippedPixels += framePixels;
+		return false;
+	}
+
+	// one region per connected group of changed cells, scaled back to the frame and grown by the margin
+	cv::Mat labels, stats, centroids;
+	const int count = cv::connectedComponentsWithStats(m_changed, labels, stats, centroids, 8, CV_32S);
+	const double scaleX = static_cast<double>(frame.cols) / smallSize.width;
+	const double scaleY = static_cast<double>(frame.rows) / smallSize.height;
+	for (int i = 1; i < count; ++i) {
+		const int* s = stats.ptr<int>(i);
+		cv::Rect region(static_cast<int>(s[cv::CC_STAT_LEFT] * scaleX) - m_params.margin,
+			static_cast<int>(s[cv::CC_STAT_TOP] * scaleY) - m_params.margin,
+			static_cast<int>(s[cv::CC_STAT_WIDTH] * scaleX) + 2 * m_params.margin,
+			static_cast<int>(s[cv::CC_STAT_HEIGHT] * scaleY) + 2 * m_params.margin);
+		region &= frameRect;
+		if (!region.empty())
+			regions.push_back(region);
+	}
+	MergeRegions(regions);
+
+	size_t regionPixels = 0;
+	for (const auto& region : regions)
+		regionPixels += static_cast<size_t>(region.area());
+	if (regionPixels > m_params.maxRegionFraction * framePixels) {
+		regions.assign(1, frameRect);
+		return true;
+	}
+	m_statistics.skippedPixels += framePixels - regionPixels;
+	return true;
+}
+
+void
+MotionGate::MergeRegions(std::vector<cv::Rect>& regions) {
+	bool merged = true;
+	while (merged) {
+		merged = false;
+		for (size_t i = 0; i < regions.size() && !merged; ++i) {
+			for (size_t j = i + 1; j < regions.size(); ++j) {
+				if ((regions[i] & regions[j]).empty())
+					continue;
+				regions[i] |= regions[j];
+				regions.erase(regions.begin() + j);
+				merged = true;
+				break;
+			}
+		}
+	}
+}
+
+void
+MotionGate::LogStatistics() const {
+	std::stringstream ss;
+	ss << "Motion gating: " << m_statistics.frames << " frames, " << m_statistics.SkippedFrameFraction() * 100.0 << "% of the frames and "
+		<< m_statistics.SkippedPixelFraction() * 100.0 << "% of the pixels skipped";
+	std::string logMsg = ss.str();
+	m_logger->LogInfo(logMsg.c_str());
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <cmath>
+
+#include "object-detection/non-maximum-suppression.h"
+
+namespace dl {
+
+void
+NonMaximumSuppression::Apply(std::vector<Detection>& detections, const NmsParameters& params, float scoreThreshold) {
+	if (params.mode == NmsMode::NONE || detections.empty())
+		return;
+
+	// one sort brings every class into a contiguous range ordered by descending confidence
+	thread_local std::vector<int> order;
+	order.resize(detections.size());
+	for (size_t i = 0; i < order.size(); ++i)
+		order[i] = static_cast<int>(i);
+	const bool perClass = params.perClass;
+	std::sort(order.begin(), order.end(), [&detections, perClass](int a, int b) {
+		const auto& da = detections[a];
+		const auto& db = detections[b];
+		if (perClass && da.classId != db.classId)
+			return da.classId < db.classId;
+		return da.confidence > db.confidence;
+	});
+
+	thread_local std::vector<int> kept;
+	kept.clear();
+	size_t begin = 0;
+	while (begin < order.size()) {
+		size_t end = begin + 1;
+		if (perClass) {
+			while (end < order.size() && detections[order[end]].classId == detections[order[begin]].classId)
+				++end;
+		}
+		else {
+			end = order.size();
+		}
+		if (params.mode == NmsMode::HARD)
+			ApplyHard(detections, order, begin, end, params, kept);
+		else
+			ApplySoft(detections, order, begin, end, params, scoreThreshold, kept);
+		begin = end;
+	}
+
+	std::sort(kept.begin(), kept.end(), [&detections](int a, int b) { return detections[a].confidence > detections[b].confidence; });
+	if (params.topK > 0 && kept.size() > static_cast<size_t>(params.topK))
+		kept.resize(params.topK);
+
+	std::vector<Detection> retVal;
+	retVal.reserve(kept.size());
+	for (int index : kept)
+		retVal.emplace_back(std::move(detections[index]));
+	detections = std::move(retVal);
+}
+
+void
+NonMaximumSuppression::Merge(std::vector<Detection>& detections, float threshold, bool perClass) {
+	if (detections.size() < 2)
+		return;
+	std::sort(detections.begin(), detections.end(), [](const Detection& a, const Detection& b) { return a.confidence > b.confidence; });
+
+	// every box is merged into the first stronger box it overlaps, grown boxes are checked again until nothing changes
+	std::vector<Detection> retVal;
+	retVal.reserve(detections.size());
+	for (auto& det : detections) {
+		bool merged = false;
+		for (auto& kept : retVal) {
+			if (perClass && kept.classId != det.classId)
+				continue;
+			const int intersection = (kept.bbox & det.bbox).area();
+			const int smallerArea = std::min(kept.bbox.area(), det.bbox.area());
+			if (smallerArea > 0 && intersection > threshold * smallerArea) {
+				kept.bbox |= det.bbox;
+				merged = true;
+				break;
+			}
+		}
+		if (!merged)
+			retVal.emplace_back(std::move(det));
+	}
+	if (retVal.size() < detections.size()) {
+		detections = std::move(retVal);
+		Merge(detections, threshold, perClass);
+	}
+	else {
+		detections = std::move(retVal);
+	}
+}
+
+float
+NonMaximumSuppression::IntersectionOverUnion(const cv::Rect& a, const cv::Rect& b) {
+	const int intersection = (a & b).area();
+	const int unionArea = a.area() + b.area() - intersection;
+	return unionArea > 0 ? static_cast<float>(intersection) / static_cast<float>(unionArea) : 0.0f;
+}
+
+void
+NonMaximumSuppression::ApplyHard(const std::vector<Detection>& detections, const std::vector<int>& order, size_t begin, size_t end,
+	const NmsParameters& params, std::vector<int>& kept) {
+	// corners of the kept boxes are stored contiguously so that the overlap test of a candidate is one linear sweep
+	thread_local std::vector<float> keptBoxes;
+	keptBoxes.clear();
+	size_t keptCount = 0;
+	for (size_t i = begin; i < end; ++i) {
+		const auto& bbox = detections[order[i]].bbox;
+		const float x1 = static_cast<float>(bbox.x);
+		const float y1 = static_cast<float>(bbox.y);
+		const float x2 = static_cast<float>(bbox.x + bbox.width);
+		const float y2 = static_cast<float>(bbox.y + bbox.height);
+		const float area = static_cast<float>(bbox.area());
+
+		bool suppressed = false;
+		for (size_t k = 0; k < keptCount && !suppressed; ++k) {
+			const float* keptBox = keptBoxes.data() + k * 5;
+			const float w = std::min(x2, keptBox[2]) - std::max(x1, keptBox[0]);
+			const float h = std::min(y2, keptBox[3]) - std::max(y1, keptBox[1]);
+			const float intersection = std::max(w, 0.0f) * std::max(h, 0.0f);
+			// iou > t  <=>  intersection > t * union, avoids the division
+			suppressed = intersection > params.iouThreshold * (area + keptBox[4] - intersection);
+		}
+		if (suppressed)
+			continue;
+
+		kept.push_back(order[i]);
+		keptBoxes.insert(keptBoxes.end(), { x1, y1, x2, y2, area });
+		++keptCount;
+		// boxes of one class come in descending confidence, later ones can not make it into the top-k anymore
+		if (params.topK > 0 && keptCount >= static_cast<size_t>(params.topK))
+			break;
+	}
+}
+
+void
+NonMaximumSuppression::ApplySoft(std::vector<Detection>& detections, const std::vector<int>& order, size_t begin, size_t end,
+	const NmsParameters& params, float scoreThreshold, std::vector<int>& kept) {
+	// remaining candidates, the best one is picked and the others decay by their overlap with it
+	thread_local std::vector<int> candidates;
+	candidates.assign(order.begin() + begin, order.begin() + end);
+	size_t keptCount = 0;
+	while (!candidates.empty()) {
+		auto best = std::max_element(candidates.begin(), candidates.end(),
+			[&detections](int a, int b) { return detections[a].confidence < detections[b].confidence; });
+		const int bestIndex = *best;
+		*best = candidates.back();
+		candidates.pop_back();
+		kept.push_back(bestIndex);
+		if (params.topK > 0 && ++keptCount >= static_cast<size_t>(params.topK))
+			break;
+
+		const auto& bestBox = detections[bestIndex].bbox;
+		size_t remaining = 0;
+		for (size_t i = 0; i < candidates.size(); ++i) {
+			auto& det = detections[candidates[i]];
+			const float iou = IntersectionOverUnion(bestBox, det.bbox);
+			if (params.mode == NmsMode::SOFT_LINEAR) {
+				if (iou > params.iouThreshold)
+					det.confidence *= 1.0f - iou;
+			}
+			else {
+				det.confidence *= std::exp(-(iou * iou) / params.sigma);
+			}
+			if (det.confidence >= scoreThreshold)
+				candidates[remaining++] = candidates[i];
+		}
+		candidates.resize(remaining);
+	}
+}
+
+}
@@ -4,99 +4,531 @@
 #include <opencv2/core.hpp>
 #include <opencv2/imgproc.hpp>
 #include <opencv2/highgui.hpp>
+#include <algorithm>
+#include <iterator>
 #include "object-detection/object-detection.h"
+#include "object-detection/backend-selector.h"
+#include "object-detection/blob-builder.h"
+#include "object-detection/detection-renderer.h"
+#include "object-detection/detector-pool.h"
+#include "object-detection/model-registry.h"
+#include "object-detection/non-maximum-suppression.h"
+#include "object-detection/output-decoder.h"
 
 std::shared_ptr<base::Logger> dl::Detector::m_logger = std::make_shared<base::Logger>();
 
 namespace dl {
 
+namespace {
+
+// model files of the properties, without them the network stays empty and the detector reports the failure
+std::shared_ptr<const ModelBuffer>
+GetModelOrEmpty(const NetworkProperties& properties) {
+    auto model = ModelRegistry::GetModel(properties);
+    return model ? model : std::make_shared<const ModelBuffer>();
+}
+
+}
+
+Detector::Detector(const NetworkProperties& properties)
+    : Detector(ModelRegistry::ResolvePrecision(properties), *GetModelOrEmpty(ModelRegistry::ResolvePrecision(properties)))
+{
+}
+
+Detector::Detector(const NetworkProperties& properties, const ModelBuffer& model, std::optional<BackendChoice> backendChoice)
+    : m_configFilePath(properties.configFilePath), m_weightFilePath(properties.weightFilePath), m_networkType(properties.networkType),
+    m_outputDecoder(OutputDecoder::Create(OutputLayout::SSD))
+{
+    m_network = ModelRegistry::CreateNetwork(properties, model);
+    ApplyBackend(properties, backendChoice);
+}
+
+void
+Detector::ApplyBackend(const NetworkProperties& properties, std::optional<BackendChoice> backendChoice) {
+    if (m_network.empty()) {
+        std::string logMsg = "Network could not be created from " + m_weightFilePath;
+        m_logger->LogError(logMsg.c_str());
+        return;
+    }
+    if (backendChoice.has_value()) {
+        m_backendChoice = backendChoice.value();
+        m_network.setPreferableBackend(m_backendChoice.backend);
+        m_network.setPreferableTarget(m_backendChoice.target);
+    }
+    else {
+        m_backendChoice = BackendSelector::Apply(m_network, properties);
+    }
+}
+
+void
+Detector::SetDetectionParameters(DetectionParameters params) {
+    m_scaleFactor = params.scaleFactor;
+    m_meanValues = params.meanValues;
+    m_inputName = params.inputName;
+    m_outputDetectionName = params.outputDetectionName;
+    m_outputMaskName = params.outputMaskName;
+    m_confidenceThreshold = params.confidenceThreshold;
+    m_nmsParameters = params.nmsParameters;
+    if (params.outputLayout != m_outputLayout) {
+        m_outputLayout = params.outputLayout;
+        m_outputDecoder = OutputDecoder::Create(m_outputLayout);
+    }
+    if (m_outputLayout == OutputLayout::YOLO && m_nmsParameters.mode == NmsMode::NONE) {
+        std::string logMsg = "YOLO outputs of " + m_weightFilePath + " are decoded without NMS, every anchor of an object stays a detection";
+        m_logger->LogWarn(logMsg.c_str());
+    }
+    m_outputDecoder->SetDetectionParameters(params);
+}
+
 DetectionResult
 Detector::Detect(const cv::Mat& frame, std::optional<Object> oneClassNetwork) {
-    DetectionResult retVal;
-    frame.copyTo(retVal.imageWithBbox);
-    frame.copyTo(retVal.originalImage);
+    auto results = DetectBatch({ frame }, oneClassNetwork);
+    return std::move(results.front());
+}
+
+std::vector<DetectionResult>
+Detector::DetectBatch(const std::vector<cv::Mat>& frames, std::optional<Object> oneClassNetwork) {
+    std::vector<DetectionResult> retVal(frames.size());
+    if (frames.empty())
+        return retVal;
+
+    // results only share the frame buffers, drawing is left to the DetectionRenderer
+    for (size_t i = 0; i < frames.size(); ++i) {
+        retVal[i].originalImage = frames[i];
+    }
+
+    // every frame is stretched to the size of the first frame and mapped back with its own scale while decoding
+    std::vector<InputMapping> mappings;
+    for (const auto& frame : frames)
+        mappings.push_back(CreateInputMapping(frame.size(), frames.front().size()));
+    CreateInputBlob(frames, frames.front().size(), m_inputBlob);
+    auto outs = Forward(m_inputBlob);
+    DecodeDetections(outs, mappings, retVal, oneClassNetwork);
+
+    return retVal;
+}
 
-    int imageWidth, imageHeight;
-    imageWidth = frame.size().width;
-    imageHeight = frame.size().height;
+void
+Detector::CreateInputBlob(const std::vector<cv::Mat>& frames, cv::Size inputSize, cv::Mat& inputBlob) const {
+    // resizing is part of the blob creation, frames can be passed in their original size
+    bool swapRB = m_networkType == NetworkType::TENSORFLOW || m_networkType == NetworkType::ONNX;
+    BlobBuilder::CreateBlob(frames, inputSize, m_scaleFactor, m_meanValues, swapRB, inputBlob);
+}
 
-    cv::Mat inputBlob;
-    if (m_networkType == NetworkType::CAFFE)
-        inputBlob = cv::dnn::blobFromImage(frame, m_scaleFactor, cv::Size(imageWidth, imageHeight), m_meanValues, false, false);
-    else if (m_networkType == NetworkType::TENSORFLOW)
-        inputBlob = cv::dnn::blobFromImage(frame, m_scaleFactor, cv::Size(imageWidth, imageHeight), m_meanValues, true, false);
+std::vector<cv::Mat>
+Detector::Forward(const cv::Mat& inputBlob) {
+    return Forward(inputBlob, *this);
+}
 
-    if (m_inputName.empty())
+std::vector<cv::Mat>
+Detector::Forward(const cv::Mat& inputBlob, const Detector& parameters) {
+    if (parameters.m_inputName.empty())
         m_network.setInput(inputBlob);
     else
-        m_network.setInput(inputBlob, m_inputName);
+        m_network.setInput(inputBlob, parameters.m_inputName);
 
     std::vector<std::string> outNames;
-    if (m_outputMaskName.empty())
-        outNames = { m_outputDetectionName };
+    if (parameters.m_outputDetectionName.empty())
+        outNames = GetOutputsNames();
+    else if (parameters.m_outputMaskName.empty())
+        outNames = { parameters.m_outputDetectionName };
     else
-        outNames = { m_outputDetectionName, m_outputMaskName };
+        outNames = { parameters.m_outputDetectionName, parameters.m_outputMaskName };
 
     std::vector<cv::Mat> outs;
     m_network.forward(outs, outNames);
+    // forward returns views of the network's own buffers, the next forward would overwrite them while
+    // the results are still being decoded on another thread
+    for (auto& out : outs)
+        out = out.clone();
+    return outs;
+}
+
+void
+Detector::DecodeDetections(const std::vector<cv::Mat>& outs, const std::vector<InputMapping>& mappings, std::vector<DetectionResult>& results,
+    std::optional<Object> oneClassNetwork, std::optional<float> confidenceThreshold) const {
+    // a lower threshold of the caller also holds for the soft NMS, otherwise the decayed boxes would be dropped again
+    const float threshold = confidenceThreshold.value_or(m_confidenceThreshold);
+    m_outputDecoder->Decode(outs, mappings, results, oneClassNetwork, threshold);
+    for (auto& result : results)
+        NonMaximumSuppression::Apply(result.detections, m_nmsParameters, threshold);
+}
+
+std::shared_ptr<Detector>
+Detector::CloneParameters() const {
+    auto retVal = std::make_shared<Detector>(*this);
+    // decoders keep their own copy of the parameters and the blob buffer would be written by both detectors
+    retVal->m_outputDecoder = OutputDecoder::Create(m_outputLayout);
+    retVal->m_inputBlob = cv::Mat();
+    return retVal;
+}
+
+InputMapping
+Detector::CreateInputMapping(cv::Size frameSize, cv::Size inputSize) {
+    InputMapping mapping;
+    mapping.inputSize = inputSize;
+    mapping.frameSize = frameSize;
+    mapping.scaleX = static_cast<float>(frameSize.width) / static_cast<float>(inputSize.width);
+    mapping.scaleY = static_cast<float>(frameSize.height) / static_cast<float>(inputSize.height);
+    return mapping;
+}
+
+std::vector<std::string>
+Detector::GetOutputsNames() {
+    // cached per detector, every network of a pool resolves its own names
+    if (m_outputsNames.empty()) {
+        std::vector<int> outLayers = m_network.getUnconnectedOutLayers();
+        std::vector<std::string> layersNames = m_network.getLayerNames();
+        m_outputsNames.resize(outLayers.size());
+        for (size_t i = 0; i < outLayers.size(); ++i)
+            m_outputsNames[i] = layersNames[outLayers[i] - 1];
+    }
+    return m_outputsNames;
+}
+
+void
+BaseDetector::InitializeDetector() {
+    // detectors of the same model share the pool and its networks, the parameters for blob creation and decoding
+    // stay with every detector so that each one can be configured on its own
+    m_detectorPool = ModelRegistry::GetDetectorPool(m_networkProperties);
+    m_detector = m_detectorPool->GetPrototype()->CloneParameters();
+}
 
-    cv::Mat detection = outs[0];
+void
+BaseDetector::SetDetectionParameters(DetectionParameters params) {
+    m_renderMode = params.renderMode;
+    m_confidenceThreshold = params.confidenceThreshold;
+    m_tilingParameters = params.tilingParameters;
+    m_detector->SetDetectionParameters(params);
+}
+
+void
+BaseDetector::SetMaxConcurrency(size_t maxNetworks) {
+    m_detectorPool->SetMaxSize(maxNetworks);
+}
 
-    cv::Mat detection_matrix(detection.size[2], detection.size[3], CV_32F, detection.ptr<float>());
-    for (int i = 0; i < detection_matrix.rows; i++) {
-        float confidence = detection_matrix.at<float>(i, m_detectionFeatureMap[DetectionFeature::CONFIDENCE]);
-        if (confidence < m_confidenceThreshold) {
-            continue;
+DetectionResult
+BaseDetector::Detect(const cv::Mat& frame, std::optional<Object> oneClassNetwork, bool oneObject) {
+    if (m_tilingParameters.enabled)
+        return DetectTiled(frame, oneClassNetwork, oneObject);
+
+    DetectionContext context;
+    context.frame = frame;
+    context.oneClassNetwork = oneClassNetwork;
+    context.oneObject = oneObject;
+    // setInput copies the blob into the network, so one blob per thread can be reused for every frame
+    thread_local cv::Mat reusableBlob;
+    context.inputBlob = reusableBlob;
+    Preprocess(context);
+    reusableBlob = context.inputBlob;
+    Forward(context);
+    Postprocess(context);
+    EstimateAttributes(context);
+    Render(context);
+    return std::move(context.result);
+}
+
+std::vector<DetectionResult>
+BaseDetector::DetectBatch(const std::vector<cv::Mat>& frames, std::optional<Object> oneClassNetwork, bool oneObject) {
+    std::vector<DetectionResult> retVal;
+    if (frames.empty())
+        return retVal;
+
+    // tiles of a frame already fill the batches
+    if (m_tilingParameters.enabled) {
+        for (const auto& frame : frames)
+            retVal.emplace_back(DetectTiled(frame, oneClassNetwork, oneObject));
+        return retVal;
+    }
+
+    std::vector<DetectionContext> contexts(frames.size());
+    std::vector<DetectionContext*> batch;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        auto& context = contexts[i];
+        context.frame = frames[i];
+        context.oneClassNetwork = oneClassNetwork;
+        context.oneObject = oneObject;
+        batch.push_back(&context);
+    }
+    DetectContexts(batch);
+
+    for (auto& context : contexts) {
+        EstimateAttributes(context);
+        Render(context);
+        retVal.emplace_back(std::move(context.result));
+    }
+    return retVal;
+}
+
+void
+BaseDetector::DetectContexts(const std::vector<DetectionContext*>& contexts) {
+    if (contexts.empty())
+        return;
+    // the blob has the input size of the first frame, every frame is mapped back from it with its own scale
+    const auto& first = contexts.front()->frame;
+    auto batchInputSize = CalculateInputSize(first, CalculateResizeRatio(first));
+    std::vector<cv::Mat> frames;
+    std::vector<InputMapping> mappings;
+    for (auto context : contexts) {
+        context->inputMapping = Detector::CreateInputMapping(context->frame.size(), batchInputSize);
+        frames.push_back(context->frame);
+        mappings.push_back(context->inputMapping);
+    }
+
+    // one forward pass for the whole batch, the decoded results are then handled frame by frame
+    thread_local cv::Mat batchBlob;
+    m_detector->CreateInputBlob(frames, batchInputSize, batchBlob);
+    std::vector<cv::Mat> outs;
+    {
+        auto detector = m_detectorPool->Acquire();
+        outs = detector->Forward(batchBlob, *m_detector);
+    }
+    std::vector<DetectionResult> decoded(frames.size());
+    m_detector->DecodeDetections(outs, mappings, decoded, contexts.front()->oneClassNetwork);
+
+    for (size_t i = 0; i < contexts.size(); ++i) {
+        auto& context = *contexts[i];
+        context.result = std::move(decoded[i]);
+        context.result.originalImage = context.frame;
+        PostprocessDetections(context);
+    }
+}
+
+void
+BaseDetector::Preprocess(DetectionContext& context) const {
+    auto inputSize = CalculateInputSize(context.frame, CalculateResizeRatio(context.frame));
+    context.inputMapping = Detector::CreateInputMapping(context.frame.size(), inputSize);
+    m_detector->CreateInputBlob({ context.frame }, inputSize, context.inputBlob);
+}
+
+void
+BaseDetector::Forward(DetectionContext& context) {
+    auto detector = m_detectorPool->Acquire();
+    context.outputs = detector->Forward(context.inputBlob, *m_detector);
+}
+
+void
+BaseDetector::Postprocess(DetectionContext& context) const {
+    // boxes come out of the decoder in frame coordinates, already clipped to the frame
+    std::vector<DetectionResult> decoded(1);
+    m_detector->DecodeDetections(context.outputs, { context.inputMapping }, decoded, context.oneClassNetwork);
+    context.result = std::move(decoded.front());
+    context.result.originalImage = context.frame;
+    PostprocessDetections(context);
+}
+
+void
+BaseDetector::Render(DetectionContext& context) const {
+    DetectionRenderer::Render(context.result, m_renderMode);
+}
+
+DetectionResult
+BaseDetector::DetectTiled(const cv::Mat& frame, std::optional<Object> oneClassNetwork, bool oneObject) {
+    const auto& tiling = m_tilingParameters;
+    DetectionContext context;
+    context.frame = frame;
+    context.oneClassNetwork = oneClassNetwork;
+    context.oneObject = oneObject;
+
+    // full frame pass for the large objects, with gating it is decoded at the coarse threshold to find the regions worth tiling
+    thread_local cv::Mat reusableBlob;
+    context.inputBlob = reusableBlob;
+    Preprocess(context);
+    reusableBlob = context.inputBlob;
+    Forward(context);
+    std::vector<DetectionResult> decoded(1);
+    std::optional<float> coarseThreshold;
+    if (tiling.coarseGating)
+        coarseThreshold = std::min(tiling.coarseConfidenceThreshold, m_confidenceThreshold);
+    m_detector->DecodeDetections(context.outputs, { context.inputMapping }, decoded, oneClassNetwork, coarseThreshold);
+
+    std::vector<Detection> detections;
+    std::vector<cv::Rect> regions;
+    for (auto& det : decoded.front().detections) {
+        regions.push_back(det.bbox);
+        if (det.confidence >= m_confidenceThreshold)
+            detections.emplace_back(std::move(det));
+    }
+
+    // tiles are stretched to the network input, their boxes are shifted by the tile origin while decoding
+    auto tiles = CalculateTiles(frame.size(), regions);
+    const cv::Size inputSize(m_networkProperties.imageInputWidth, m_networkProperties.imageInputHeight);
+    const size_t tilesPerBatch = static_cast<size_t>(std::max(1, tiling.maxTilesPerBatch));
+    thread_local cv::Mat tileBlob;
+    std::vector<cv::Mat> tileImages;
+    std::vector<InputMapping> mappings;
+    for (size_t begin = 0; begin < tiles.size(); begin += tilesPerBatch) {
+        const size_t end = std::min(tiles.size(), begin + tilesPerBatch);
+        tileImages.clear();
+        mappings.clear();
+        for (size_t i = begin; i < end; ++i) {
+            tileImages.push_back(frame(tiles[i]));
+            auto mapping = Detector::CreateInputMapping(tiles[i].size(), inputSize);
+            mapping.frameSize = frame.size();
+            mapping.padX = -static_cast<float>(tiles[i].x) / mapping.scaleX;
+            mapping.padY = -static_cast<float>(tiles[i].y) / mapping.scaleY;
+            mappings.push_back(mapping);
         }
-        int classId = static_cast<int>(detection_matrix.at<float>(i, m_detectionFeatureMap[DetectionFeature::CLASS_ID]));
-        int left = static_cast<int>(detection_matrix.at<float>(i, m_detectionFeatureMap[DetectionFeature::BBOX_LEFT]) * frame.cols);
-        int top = static_cast<int>(detection_matrix.at<float>(i, m_detectionFeatureMap[DetectionFeature::BBOX_TOP]) * frame.rows);
-        int right = static_cast<int>(detection_matrix.at<float>(i, m_detectionFeatureMap[DetectionFeature::BBOX_RIGHT]) * frame.cols);
-        int bottom = static_cast<int>(detection_matrix.at<float>(i, m_detectionFeatureMap[DetectionFeature::BBOX_BOTTOM]) * frame.rows);
-        Detection res;
-        res.bbox = cv::Rect(left, top, (right - left), (bottom - top));
-        res.confidence = confidence;
-        res.classId = classId;
-        cv::Point textPoint = cv::Point(res.bbox.x, res.bbox.y + 15);
-        cv::putText(retVal.imageWithBbox, std::to_string(res.confidence), textPoint, 1, 1, cv::Scalar(255, 0, 0));
-        if (oneClassNetwork.has_value()) {
-            res.objectClass = oneClassNetwork.value();
-            res.objectClassString = ConvertObjectTypeToString(oneClassNetwork.value());
+        m_detector->CreateInputBlob(tileImages, inputSize, tileBlob);
+        std::vector<cv::Mat> outs;
+        {
+            auto detector = m_detectorPool->Acquire();
+            outs = detector->Forward(tileBlob, *m_detector);
         }
-        // segmentation result
-        if (!m_outputMaskName.empty()) {
-            cv::Mat outMasks = outs[1];
-            cv::Mat objectMask(outMasks.size[2], outMasks.size[3], CV_32F, outMasks.ptr<float>(i, classId));
-			SegmentationDrawingElement e;
-			e.mask = objectMask;
-			e.bbox = res.bbox;
-			res.drawingElement = e;
-		}
-        retVal.detections.emplace_back(std::move(res));
+        std::vector<DetectionResult> tileResults(end - begin);
+        m_detector->DecodeDetections(outs, mappings, tileResults, oneClassNetwork);
+        for (auto& tileResult : tileResults)
+            for (auto& det : tileResult.detections)
+                detections.emplace_back(std::move(det));
+    }
+
+    // the same object is found by the full frame pass and by every tile it reaches into
+    NonMaximumSuppression::Merge(detections, tiling.mergeThreshold);
+    context.result.detections = std::move(detections);
+    context.result.originalImage = frame;
+    PostprocessDetections(context);
+    EstimateAttributes(context);
+    Render(context);
+    return std::move(context.result);
+}
+
+DetectionResult
+BaseDetector::DetectGated(const cv::Mat& frame, GatedStream& stream, std::optional<Object> oneClassNetwork, bool oneObject) {
+    // the gate and the kept detections belong to the stream of the caller, the detector itself keeps no frame history
+    std::vector<cv::Rect> regions;
+    const bool changed = stream.motionGate.Update(frame, regions);
+    const bool wholeFrame = regions.size() == 1 && regions.front() == cv::Rect(0, 0, frame.cols, frame.rows);
+    if (changed && wholeFrame) {
+        auto result = Detect(frame, oneClassNetwork, oneObject);
+        stream.lastDetections = result.detections;
+        return result;
     }
 
-    for (auto& det : retVal.detections) {
-        cv::rectangle(retVal.imageWithBbox, det.bbox, cv::Scalar(0, 255, 0), 1, 8, 0);
-        if (det.objectClassString.has_value()) {
-            cv::Point textPoint = cv::Point(det.bbox.x, det.bbox.y);
-            cv::putText(retVal.imageWithBbox, det.objectClassString.value(), textPoint, 1, 1, cv::Scalar(255, 0, 0));
+    DetectionContext context;
+    context.frame = frame;
+    context.oneClassNetwork = oneClassNetwork;
+    context.result.originalImage = frame;
+    if (changed) {
+        // new detections only come from the changed regions and go through postprocessing and the attribute networks
+        std::vector<Detection> detections;
+        for (const auto& region : regions) {
+            auto regionDetections = DetectRegion(frame, region, oneClassNetwork);
+            std::move(regionDetections.begin(), regionDetections.end(), std::back_inserter(detections));
         }
+        NonMaximumSuppression::Merge(detections, stream.motionGate.GetParameters().mergeThreshold);
+        context.result.detections = std::move(detections);
+        PostprocessDetections(context);
+        EstimateAttributes(context);
+        // detections of the static part of the frame are still valid
+        for (const auto& det : stream.lastDetections) {
+            bool touched = std::any_of(regions.begin(), regions.end(), [&det](const cv::Rect& region) { return (det.bbox & region).area() > 0; });
+            if (!touched)
+                context.result.detections.push_back(det);
+        }
+        stream.lastDetections = context.result.detections;
+    }
+    else {
+        context.result.detections = stream.lastDetections;
     }
 
-    return retVal;
+    if (oneObject) {
+        context.oneObject = true;
+        BaseDetector::PostprocessDetections(context);
+    }
+    Render(context);
+    return std::move(context.result);
 }
 
-std::vector<std::string>
-Detector::GetOutputsNames(const cv::dnn::Net& net) {
-    static std::vector<std::string> names;
-    if (names.empty()) {
-        std::vector<int> outLayers = net.getUnconnectedOutLayers();
-        std::vector<std::string> layersNames = net.getLayerNames();
-        names.resize(outLayers.size());
-        for (size_t i = 0; i < outLayers.size(); ++i)
-            names[i] = layersNames[outLayers[i] - 1];
+std::vector<Detection>
+BaseDetector::DetectRegion(const cv::Mat& frame, const cv::Rect& region, std::optional<Object> oneClassNetwork) {
+    DetectionContext context;
+    context.frame = frame(region);
+    context.oneClassNetwork = oneClassNetwork;
+    thread_local cv::Mat reusableBlob;
+    context.inputBlob = reusableBlob;
+    Preprocess(context);
+    reusableBlob = context.inputBlob;
+    // boxes are shifted by the region origin while decoding, the same way tiles are placed
+    context.inputMapping.frameSize = frame.size();
+    context.inputMapping.padX -= static_cast<float>(region.x) / context.inputMapping.scaleX;
+    context.inputMapping.padY -= static_cast<float>(region.y) / context.inputMapping.scaleY;
+    Forward(context);
+    std::vector<DetectionResult> decoded(1);
+    m_detector->DecodeDetections(context.outputs, { context.inputMapping }, decoded, oneClassNetwork);
+    // decoded masks own their pixels, the detections stay valid after the outputs of the region are gone
+    return std::move(decoded.front().detections);
+}
+
+std::vector<cv::Rect>
+BaseDetector::CalculateTiles(const cv::Size& frameSize, const std::vector<cv::Rect>& regions) const {
+    std::vector<cv::Rect> tiles;
+    cv::Size tileSize = m_tilingParameters.tileSize;
+    if (tileSize.empty())
+        tileSize = cv::Size(2 * m_networkProperties.imageInputWidth, 2 * m_networkProperties.imageInputHeight);
+    // a frame that fits into one tile is already covered by the full frame pass
+    if (tileSize.empty() || (frameSize.width <= tileSize.width && frameSize.height <= tileSize.height))
+        return tiles;
+    tileSize.width = std::min(tileSize.width, frameSize.width);
+    tileSize.height = std::min(tileSize.height, frameSize.height);
+
+    // the last tile of a row or column is moved back to end at the frame border
+    auto Origins = [this](int frameLength, int tileLength) {
+        std::vector<int> origins;
+        const int step = std::max(1, static_cast<int>(tileLength * (1.0f - m_tilingParameters.overlap)));
+        for (int origin = 0; ; origin += step) {
+            if (origin + tileLength >= frameLength) {
+                origins.push_back(frameLength - tileLength);
+                break;
+            }
+            origins.push_back(origin);
+        }
+        return origins;
+    };
+    auto originsX = Origins(frameSize.width, tileSize.width);
+    auto originsY = Origins(frameSize.height, tileSize.height);
+    for (int y : originsY) {
+        for (int x : originsX) {
+            cv::Rect tile(x, y, tileSize.width, tileSize.height);
+            if (m_tilingParameters.coarseGating) {
+                bool touched = std::any_of(regions.begin(), regions.end(), [&tile](const cv::Rect& region) { return (tile & region).area() > 0; });
+                if (!touched)
+                    continue;
+            }
+            tiles.push_back(tile);
+        }
+    }
+    return tiles;
+}
+
+void
+BaseDetector::PostprocessDetections(DetectionContext& context) const {
+    auto& retVal = context.result;
+    if (!context.oneObject || retVal.detections.size() < 2)
+        return;
+
+    // keep the detection closest to the center of the frame
+    auto frameWidth = context.frame.size().width;
+    auto frameHeight = context.frame.size().height;
+    double maxDistance = static_cast<double>(frameWidth);
+    std::optional<size_t> closest;
+    for (size_t i = 0; i < retVal.detections.size(); ++i) {
+        const auto& det = retVal.detections[i];
+        auto dist1 = (((2 * det.bbox.x) + det.bbox.width) / 2) - (frameWidth / 2);
+        auto dist2 = (((2 * det.bbox.y) + det.bbox.height) / 2) - (frameHeight / 2);
+        double distance = std::sqrt(std::pow(dist1, 2) + std::pow(dist2, 2));
+        if (distance < maxDistance) {
+            closest = i;
+            maxDistance = distance;
+        }
+    }
+    if (closest.has_value()) {
+        auto oneDetection = std::move(retVal.detections[closest.value()]);
+        retVal.detections.clear();
+        retVal.detections.emplace_back(std::move(oneDetection));
+    }
+    else {
+        retVal.detections.clear();
     }
-    return names;
 }
 
 std::string 
@@ -0,0 +1,16 @@
+#include "object-detection/output-decoder.h"
+#include "object-detection/ssd-output-decoder.h"
+#include "object-detection/yolo-output-decoder.h"
+
+namespace dl {
+
+std::shared_ptr<OutputDecoder>
+OutputDecoder::Create(OutputLayout layout) {
+	switch (layout) {
+	case OutputLayout::YOLO: return std::make_shared<YoloOutputDecoder>();
+	case OutputLayout::SSD:
+	default: return std::make_shared<SsdOutputDecoder>();
+	}
+}
+
+}
@@ -0,0 +1,158 @@
+#include <logger/logger.h>
+#include <assertion/assertion.h>
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <cstring>
+
+#include "object-detection/rle-mask.h"
+
+namespace dl {
+
+namespace {
+
+// foreground intervals as (row, begin, end) in frame coordinates, ordered by row and begin
+void
+CollectIntervals(const RleMask& mask, std::vector<cv::Vec3i>& intervals) {
+	intervals.clear();
+	mask.ForEachInterval([&intervals](int row, int begin, int end) {
+		intervals.emplace_back(row, begin, end);
+	});
+}
+
+}
+
+RleMask
+RleMask::Encode(const cv::Mat& mask, const cv::Rect& bbox) {
+	ASSERT((mask.type() == CV_8U && mask.size() == bbox.size()), "Mask must be a CV_8U matrix of the bbox size", base::Logger::Severity::Error);
+	RleMask rle;
+	rle.m_bbox = bbox;
+	for (int y = 0; y < mask.rows; ++y) {
+		const uchar* row = mask.ptr<uchar>(y);
+		const size_t offset = static_cast<size_t>(y) * mask.cols;
+		int x = 0;
+		while (x < mask.cols) {
+			while (x < mask.cols && !row[x])
+				++x;
+			const int begin = x;
+			while (x < mask.cols && row[x])
+				++x;
+			if (x > begin)
+				rle.AppendForeground(offset + begin, offset + x);
+		}
+	}
+	rle.Finish();
+	return rle;
+}
+
+void
+RleMask::Decode(cv::Mat& roi) const {
+	roi.create(m_bbox.size(), CV_8U);
+	roi.setTo(cv::Scalar::all(0));
+	ForEachInterval([this, &roi](int row, int begin, int end) {
+		std::memset(roi.ptr<uchar>(row - m_bbox.y) + (begin - m_bbox.x), 255, end - begin);
+	});
+}
+
+size_t
+RleMask::Intersection(const RleMask& a, const RleMask& b) {
+	if (a.Empty() || b.Empty() || (a.m_bbox & b.m_bbox).empty())
+		return 0;
+	thread_local std::vector<cv::Vec3i> first;
+	thread_local std::vector<cv::Vec3i> second;
+	CollectIntervals(a, first);
+	CollectIntervals(b, second);
+
+	// both lists are sorted, so a single merge walk finds every overlapping pair
+	size_t intersection = 0;
+	size_t i = 0;
+	size_t j = 0;
+	while (i < first.size() && j < second.size()) {
+		const auto& x = first[i];
+		const auto& y = second[j];
+		if (x[0] != y[0]) {
+			if (x[0] < y[0])
+				++i;
+			else
+				++j;
+			continue;
+		}
+		const int begin = std::max(x[1], y[1]);
+		const int end = std::min(x[2], y[2]);
+		if (end > begin)
+			intersection += end - begin;
+		if (x[2] < y[2])
+			++i;
+		else
+			++j;
+	}
+	return intersection;
+}
+
+float
+RleMask::IntersectionOverUnion(const RleMask& a, const RleMask& b) {
+	const size_t intersection = Intersection(a, b);
+	const size_t unionArea = a.m_area + b.m_area - intersection;
+	return unionArea > 0 ? static_cast<float>(intersection) / unionArea : 0.0f;
+}
+
+RleMask
+RleMask::Union(const RleMask& a, const RleMask& b) {
+	if (a.Empty())
+		return b;
+	if (b.Empty())
+		return a;
+	thread_local std::vector<cv::Vec3i> first;
+	thread_local std::vector<cv::Vec3i> second;
+	thread_local std::vector<cv::Vec3i> merged;
+	CollectIntervals(a, first);
+	CollectIntervals(b, second);
+	merged.resize(first.size() + second.size());
+	std::merge(first.begin(), first.end(), second.begin(), second.end(), merged.begin(), [](const cv::Vec3i& x, const cv::Vec3i& y) {
+		return x[0] != y[0] ? x[0] < y[0] : x[1] < y[1];
+	});
+
+	RleMask rle;
+	rle.m_bbox = a.m_bbox | b.m_bbox;
+	const auto offset = [&rle](int row, int x) {
+		return static_cast<size_t>(row - rle.m_bbox.y) * rle.m_bbox.width + (x - rle.m_bbox.x);
+	};
+	// overlapping intervals of the same row are joined before they are appended
+	cv::Vec3i current = merged.front();
+	for (size_t i = 1; i < merged.size(); ++i) {
+		const auto& next = merged[i];
+		if (next[0] == current[0] && next[1] <= current[2]) {
+			current[2] = std::max(current[2], next[2]);
+			continue;
+		}
+		rle.AppendForeground(offset(current[0], current[1]), offset(current[0], current[2]));
+		current = next;
+	}
+	rle.AppendForeground(offset(current[0], current[1]), offset(current[0], current[2]));
+	rle.Finish();
+	return rle;
+}
+
+void
+RleMask::AppendForeground(size_t begin, size_t end) {
+	// counts always end with a foreground run here, so touching runs are extended instead of separated by a zero
+	if (begin == m_length && !m_counts.empty()) {
+		m_counts.back() += static_cast<uint32_t>(end - begin);
+	}
+	else {
+		m_counts.push_back(static_cast<uint32_t>(begin - m_length));
+		m_counts.push_back(static_cast<uint32_t>(end - begin));
+	}
+	m_area += end - begin;
+	m_length = end;
+}
+
+void
+RleMask::Finish() {
+	const size_t total = static_cast<size_t>(std::max(m_bbox.area(), 0));
+	if (m_length < total)
+		m_counts.push_back(static_cast<uint32_t>(total - m_length));
+	m_length = total;
+	m_counts.shrink_to_fit();
+}
+
+}
\ No newline at end of file
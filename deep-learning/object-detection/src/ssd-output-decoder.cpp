@@ -0,0 +1,86 @@
+#include <opencv2/core.hpp>
+
+#include "object-detection/ssd-output-decoder.h"
+
+namespace dl {
+
+void
+SsdOutputDecoder::SetDetectionParameters(const DetectionParameters& params) {
+	auto Column = [&params](DetectionFeature feature, int defaultColumn) {
+		auto it = params.detectionFeatureMap.find(feature);
+		return it != params.detectionFeatureMap.end() ? it->second : defaultColumn;
+	};
+	// without an image id column every row belongs to the first image
+	m_imageIdColumn = Column(DetectionFeature::IMAGE_ID, -1);
+	m_classIdColumn = Column(DetectionFeature::CLASS_ID, 1);
+	m_confidenceColumn = Column(DetectionFeature::CONFIDENCE, 2);
+	m_leftColumn = Column(DetectionFeature::BBOX_LEFT, 3);
+	m_topColumn = Column(DetectionFeature::BBOX_TOP, 4);
+	m_rightColumn = Column(DetectionFeature::BBOX_RIGHT, 5);
+	m_bottomColumn = Column(DetectionFeature::BBOX_BOTTOM, 6);
+	// without an explicit mask output the network may still have further outputs, they are not masks
+	m_hasMaskOutput = !params.outputMaskName.empty();
+}
+
+void
+SsdOutputDecoder::Decode(const std::vector<cv::Mat>& outs, const std::vector<InputMapping>& mappings, std::vector<DetectionResult>& results,
+	std::optional<Object> oneClassNetwork, float confidenceThreshold) const {
+	const cv::Mat& detection = outs[0];
+	const int rows = detection.size[2];
+	const int cols = detection.size[3];
+	const float* data = detection.ptr<float>();
+
+	// branchless compaction of the rows above the threshold, the buffer is kept per thread
+	thread_local std::vector<int> candidates;
+	candidates.resize(rows);
+	int candidateCount = 0;
+	for (int i = 0; i < rows; ++i) {
+		candidates[candidateCount] = i;
+		candidateCount += data[i * cols + m_confidenceColumn] >= confidenceThreshold;
+	}
+	for (auto& result : results)
+		result.detections.reserve(result.detections.size() + candidateCount);
+
+	std::optional<std::string> objectClassString;
+	if (oneClassNetwork.has_value())
+		objectClassString = Detector::ConvertObjectTypeToString(oneClassNetwork.value());
+
+	const int imageCount = static_cast<int>(results.size());
+	for (int c = 0; c < candidateCount; ++c) {
+		const int i = candidates[c];
+		const float* row = data + i * cols;
+		const int imageId = m_imageIdColumn >= 0 ? static_cast<int>(row[m_imageIdColumn]) : 0;
+		if (imageId < 0 || imageId >= imageCount)
+			continue;
+		// normalized input coordinates -> input pixels -> frame pixels, clipped to the frame
+		const auto& mapping = mappings[imageId];
+		const float inputWidth = static_cast<float>(mapping.inputSize.width);
+		const float inputHeight = static_cast<float>(mapping.inputSize.height);
+		cv::Rect bbox;
+		if (!MapBox(mapping, row[m_leftColumn] * inputWidth, row[m_topColumn] * inputHeight,
+			row[m_rightColumn] * inputWidth, row[m_bottomColumn] * inputHeight, bbox))
+			continue;
+
+		auto& res = results[imageId].detections.emplace_back();
+		res.bbox = bbox;
+		res.confidence = row[m_confidenceColumn];
+		res.classId = static_cast<int>(row[m_classIdColumn]);
+		if (oneClassNetwork.has_value()) {
+			res.objectClass = oneClassNetwork.value();
+			res.objectClassString = objectClassString;
+		}
+		// segmentation result, mask rows follow the detection rows
+		if (m_hasMaskOutput && outs.size() > 1) {
+			const cv::Mat& outMasks = outs[1];
+			cv::Mat objectMask(outMasks.size[2], outMasks.size[3], CV_32F, const_cast<float*>(outMasks.ptr<float>(i, res.classId)));
+			SegmentationDrawingElement e;
+			// the detections outlive the outputs, e.g. tiles and motion regions are postprocessed together after
+			// their forward passes, so the small low resolution mask gets its own buffer
+			e.networkMask = objectMask.clone();
+			e.bbox = res.bbox;
+			res.drawingElement = e;
+		}
+	}
+}
+
+}
@@ -0,0 +1,111 @@
+#include <logger/logger.h>
+#include <opencv2/core.hpp>
+#include <algorithm>
+
+#include "object-detection/yolo-output-decoder.h"
+
+std::shared_ptr<base::Logger> dl::YoloOutputDecoder::m_logger = std::make_shared<base::Logger>();
+
+namespace dl {
+
+void
+YoloOutputDecoder::SetDetectionParameters(const DetectionParameters& params) {
+	m_normalizedBoxes = params.normalizedBoxes;
+}
+
+void
+YoloOutputDecoder::Decode(const std::vector<cv::Mat>& outs, const std::vector<InputMapping>& mappings, std::vector<DetectionResult>& results,
+	std::optional<Object> oneClassNetwork, float confidenceThreshold) const {
+	std::optional<std::string> objectClassString;
+	if (oneClassNetwork.has_value())
+		objectClassString = Detector::ConvertObjectTypeToString(oneClassNetwork.value());
+	const int imageCount = std::min(static_cast<int>(results.size()), static_cast<int>(mappings.size()));
+
+	for (const auto& out : outs) {
+		// [B, N, 5 + C] holds one grid per image, [B * N, 5 + C] stacks the rows of all images of the batch
+		const int dims = out.dims;
+		if (dims < 2)
+			continue;
+		const int cols = out.size[dims - 1];
+		if (cols <= 5)
+			continue;
+		int batch = dims > 2 ? out.size[0] : 1;
+		int rows = out.size[dims - 2];
+		if (dims == 2 && imageCount > 1) {
+			// the shape comes from the model, an output that does not fit the batch is skipped rather than misassigned
+			if (rows % imageCount != 0) {
+				std::string logMsg = "YOLO output of " + std::to_string(rows) + " rows can not be split between " + std::to_string(imageCount) + " images, skipped";
+				m_logger->LogWarn(logMsg.c_str());
+				continue;
+			}
+			batch = imageCount;
+			rows /= imageCount;
+		}
+		const float* data = out.ptr<float>();
+
+		for (int imageId = 0; imageId < std::min(batch, imageCount); ++imageId) {
+			const float* grid = data + static_cast<size_t>(imageId) * rows * cols;
+			const int chunkCount = std::max(1, (rows + ROWS_PER_CHUNK - 1) / ROWS_PER_CHUNK);
+			std::vector<std::vector<Candidate>> chunks(chunkCount);
+			cv::parallel_for_(cv::Range(0, chunkCount), [&](const cv::Range& range) {
+				for (int chunk = range.start; chunk < range.end; ++chunk) {
+					const int begin = chunk * ROWS_PER_CHUNK;
+					const int end = std::min(rows, begin + ROWS_PER_CHUNK);
+					DecodeRows(grid, begin, end, cols, mappings[imageId], confidenceThreshold, chunks[chunk]);
+				}
+			});
+
+			// merged in chunk order so that the result does not depend on the scheduling
+			auto& detections = results[imageId].detections;
+			size_t total = 0;
+			for (const auto& chunk : chunks)
+				total += chunk.size();
+			detections.reserve(detections.size() + total);
+			for (const auto& chunk : chunks) {
+				for (const auto& candidate : chunk) {
+					auto& res = detections.emplace_back();
+					res.bbox = candidate.bbox;
+					res.confidence = candidate.confidence;
+					res.classId = candidate.classId;
+					if (oneClassNetwork.has_value()) {
+						res.objectClass = oneClassNetwork.value();
+						res.objectClassString = objectClassString;
+					}
+				}
+			}
+		}
+	}
+}
+
+void
+YoloOutputDecoder::DecodeRows(const float* data, int begin, int end, int cols, const InputMapping& mapping, float confidenceThreshold,
+	std::vector<Candidate>& candidates) const {
+	const float boxScaleX = m_normalizedBoxes ? static_cast<float>(mapping.inputSize.width) : 1.0f;
+	const float boxScaleY = m_normalizedBoxes ? static_cast<float>(mapping.inputSize.height) : 1.0f;
+	const int classCount = cols - 5;
+	for (int i = begin; i < end; ++i) {
+		const float* row = data + static_cast<size_t>(i) * cols;
+		// the class score only lowers the objectness, most cells are rejected before their scores are read
+		const float objectness = row[4];
+		if (objectness < confidenceThreshold)
+			continue;
+		const float* scores = row + 5;
+		const int classId = static_cast<int>(std::max_element(scores, scores + classCount) - scores);
+		const float confidence = objectness * scores[classId];
+		if (confidence < confidenceThreshold)
+			continue;
+
+		const float halfWidth = row[2] * boxScaleX * 0.5f;
+		const float halfHeight = row[3] * boxScaleY * 0.5f;
+		const float centerX = row[0] * boxScaleX;
+		const float centerY = row[1] * boxScaleY;
+		Candidate candidate;
+		if (!MapBox(mapping, centerX - halfWidth, centerY - halfHeight, centerX + halfWidth, centerY + halfHeight, candidate.bbox))
+			continue;
+		candidate.classId = classId;
+		candidate.confidence = confidence;
+		candidates.push_back(candidate);
+	}
+}
+
+}
@@ -0,0 +1,156 @@
+#include <catch2/catch.hpp>
+#include <object-detection/rle-mask.h>
+#include <logger/logger.h>
+#include <cstdint>
+#include <vector>
+
+auto rleMaskLogger = std::make_shared<base::Logger>();
+
+namespace {
+
+const cv::Size FRAME_SIZE(40, 30);
+
+// deterministic pseudo random 0/1 mask, density in percent
+cv::Mat CreateMask(cv::Size size, int density, uint32_t seed) {
+	cv::Mat mask(size, CV_8U, cv::Scalar(0));
+	for (int y = 0; y < size.height; ++y) {
+		for (int x = 0; x < size.width; ++x) {
+			seed = seed * 1664525u + 1013904223u;
+			mask.at<uchar>(y, x) = (seed >> 24) % 100 < static_cast<uint32_t>(density) ? 1 : 0;
+		}
+	}
+	return mask;
+}
+
+// dense reference, the non-zero pixels of the mask as 255 in an otherwise empty frame
+cv::Mat PlaceMask(const cv::Mat& mask, const cv::Rect& bbox) {
+	cv::Mat frame(FRAME_SIZE, CV_8U, cv::Scalar(0));
+	for (int y = 0; y < mask.rows; ++y)
+		for (int x = 0; x < mask.cols; ++x)
+			if (mask.at<uchar>(y, x))
+				frame.at<uchar>(bbox.y + y, bbox.x + x) = 255;
+	return frame;
+}
+
+cv::Mat DecodeIntoFrame(const dl::RleMask& rle) {
+	cv::Mat roi;
+	rle.Decode(roi);
+	return PlaceMask(roi, rle.GetBbox());
+}
+
+size_t CountEqual(const cv::Mat& a, const cv::Mat& b, uchar value) {
+	size_t count = 0;
+	for (int y = 0; y < a.rows; ++y)
+		for (int x = 0; x < a.cols; ++x)
+			if (a.at<uchar>(y, x) == value && b.at<uchar>(y, x) == value)
+				++count;
+	return count;
+}
+
+size_t CountAny(const cv::Mat& a, const cv::Mat& b) {
+	size_t count = 0;
+	for (int y = 0; y < a.rows; ++y)
+		for (int x = 0; x < a.cols; ++x)
+			if (a.at<uchar>(y, x) || b.at<uchar>(y, x))
+				++count;
+	return count;
+}
+
+bool Equal(const cv::Mat& a, const cv::Mat& b) {
+	if (a.size() != b.size())
+		return false;
+	for (int y = 0; y < a.rows; ++y)
+		for (int x = 0; x < a.cols; ++x)
+			if (a.at<uchar>(y, x) != b.at<uchar>(y, x))
+				return false;
+	return true;
+}
+
+}
+
+TEST_CASE("Rle Mask Encode Decode") {
+	rleMaskLogger << MESSAGE("Rle Mask Encode Decode Test", base::Logger::Severity::Info);
+	const cv::Rect bbox(5, 3, 13, 9);
+	for (int density : { 0, 10, 50, 90, 100 }) {
+		auto mask = CreateMask(bbox.size(), density, 7u + density);
+		auto rle = dl::RleMask::Encode(mask, bbox);
+		auto reference = PlaceMask(mask, bbox);
+		CHECK(Equal(DecodeIntoFrame(rle), reference));
+		CHECK(rle.Area() == CountEqual(reference, reference, 255));
+		CHECK(rle.Empty() == (density == 0));
+		// the runs cover the whole bbox
+		size_t total = 0;
+		for (auto count : rle.GetCounts())
+			total += count;
+		CHECK(total == static_cast<size_t>(bbox.area()));
+	}
+}
+
+TEST_CASE("Rle Mask Runs Wrap Across Rows") {
+	rleMaskLogger << MESSAGE("Rle Mask Runs Wrap Across Rows Test", base::Logger::Severity::Info);
+	// the end of the first row touches the start of the second one, both become a single run
+	cv::Mat mask(3, 4, CV_8U, cv::Scalar(0));
+	mask.at<uchar>(0, 2) = 1;
+	mask.at<uchar>(0, 3) = 1;
+	mask.at<uchar>(1, 0) = 1;
+	mask.at<uchar>(1, 1) = 1;
+	mask.at<uchar>(1, 2) = 1;
+	const cv::Rect bbox(10, 20, 4, 3);
+	auto rle = dl::RleMask::Encode(mask, bbox);
+	CHECK(rle.GetCounts() == std::vector<uint32_t>{ 2, 5, 5 });
+	CHECK(rle.Area() == 5);
+	CHECK(Equal(DecodeIntoFrame(rle), PlaceMask(mask, bbox)));
+
+	// the run is still reported per row in frame coordinates
+	std::vector<cv::Vec3i> intervals;
+	rle.ForEachInterval([&intervals](int row, int begin, int end) { intervals.emplace_back(row, begin, end); });
+	REQUIRE(intervals.size() == 2);
+	CHECK(intervals[0] == cv::Vec3i(20, 12, 14));
+	CHECK(intervals[1] == cv::Vec3i(21, 10, 13));
+
+	// a mask starting with foreground keeps the leading empty background run
+	cv::Mat full(2, 3, CV_8U, cv::Scalar(1));
+	auto fullRle = dl::RleMask::Encode(full, cv::Rect(0, 0, 3, 2));
+	CHECK(fullRle.GetCounts() == std::vector<uint32_t>{ 0, 6 });
+}
+
+TEST_CASE("Rle Mask Intersection And Union") {
+	rleMaskLogger << MESSAGE("Rle Mask Intersection And Union Test", base::Logger::Severity::Info);
+	const cv::Rect first(2, 1, 17, 12);
+	// overlapping, contained, touching and disjoint placements of the second mask
+	const std::vector<cv::Rect> seconds = { cv::Rect(9, 6, 20, 15), cv::Rect(4, 3, 6, 5), cv::Rect(19, 1, 8, 12), cv::Rect(25, 18, 10, 10) };
+	uint32_t seed = 3;
+	for (const auto& second : seconds) {
+		for (int density : { 30, 70, 100 }) {
+			auto maskA = CreateMask(first.size(), density, seed++);
+			auto maskB = CreateMask(second.size(), density, seed++);
+			auto a = dl::RleMask::Encode(maskA, first);
+			auto b = dl::RleMask::Encode(maskB, second);
+			auto denseA = PlaceMask(maskA, first);
+			auto denseB = PlaceMask(maskB, second);
+
+			const size_t intersection = CountEqual(denseA, denseB, 255);
+			const size_t unionArea = CountAny(denseA, denseB);
+			CHECK(dl::RleMask::Intersection(a, b) == intersection);
+			CHECK(dl::RleMask::Intersection(b, a) == intersection);
+			CHECK(dl::RleMask::IntersectionOverUnion(a, b) == Approx(unionArea ? static_cast<float>(intersection) / unionArea : 0.0f));
+
+			auto merged = dl::RleMask::Union(a, b);
+			CHECK(merged.GetBbox() == (first | second));
+			CHECK(merged.Area() == unionArea);
+			cv::Mat reference(FRAME_SIZE, CV_8U, cv::Scalar(0));
+			for (int y = 0; y < reference.rows; ++y)
+				for (int x = 0; x < reference.cols; ++x)
+					if (denseA.at<uchar>(y, x) || denseB.at<uchar>(y, x))
+						reference.at<uchar>(y, x) = 255;
+			CHECK(Equal(DecodeIntoFrame(merged), reference));
+		}
+	}
+
+	// an empty mask adds nothing
+	auto a = dl::RleMask::Encode(CreateMask(first.size(), 50, 11u), first);
+	auto empty = dl::RleMask::Encode(cv::Mat(4, 4, CV_8U, cv::Scalar(0)), cv::Rect(0, 0, 4, 4));
+	CHECK(dl::RleMask::Intersection(a, empty) == 0);
+	CHECK(dl::RleMask::IntersectionOverUnion(a, empty) == Approx(0.0f));
+	CHECK(dl::RleMask::Union(a, empty).GetCounts() == a.GetCounts());
+}
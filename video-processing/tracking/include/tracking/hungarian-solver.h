@@ -0,0 +1,15 @@
+#pragma once
+
+#include <vector>
+
+namespace video {
+
+// minimum cost assignment of rows to columns (Kuhn-Munkres with potentials, O(n^2 m)), the matrix may be rectangular
+class HungarianSolver {
+public:
+	// cost holds rows * cols values in row-major order, assignment gets the column of every row or -1 for rows left
+	// over when there are more rows than columns
+	static void Solve(const std::vector<double>& cost, int rows, int cols, std::vector<int>& assignment);
+};
+
+}
\ No newline at end of file
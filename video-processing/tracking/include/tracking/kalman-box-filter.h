@@ -0,0 +1,27 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+namespace video {
+
+// constant velocity model of a box as used by SORT, the state is (cx, cy, area, aspect ratio) plus the velocities of
+// the first three, the aspect ratio is assumed to stay constant
+class KalmanBoxFilter {
+public:
+	KalmanBoxFilter() = default;
+	KalmanBoxFilter(const cv::Rect& box);
+
+	// advances the state by one frame and returns the predicted box
+	cv::Rect Predict();
+	// corrects the state with a measured box
+	void Correct(const cv::Rect& box);
+	cv::Rect GetBox() const;
+
+private:
+	static cv::Mat ConvertBoxToMeasurement(const cv::Rect& box);
+	static cv::Rect ConvertStateToBox(const cv::Mat& state);
+
+	cv::KalmanFilter m_filter;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <tracking/tracking.h>
+#include <detection-pipeline/detection-batcher.h>
+#include <concurrency/concurrency.h>
+#include <opencv2/videoio.hpp>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace base {
+	class Logger;
+	class ThreadPool;
+}
+
+namespace video {
+
+struct MultiStreamParameters {
+	// frames a stream may decode ahead of its tracker, files wait while the queue is full, live sources (camera
+	// indices and urls) can not wait and drop the newest frame instead unless dropLiveFrames is off
+	size_t queueCapacity = 2;
+	bool dropLiveFrames = true;
+	int redetectSteps = 30;
+	RedetectionParameters redetectionParameters;
+	AssociationParameters associationParameters;
+	dl::BatchingParameters batchingParameters;
+	// workers of the pool shared by the visual trackers of all streams, 0 uses the number of hardware threads
+	size_t trackerThreads = 0;
+};
+
+struct StreamStatistics {
+	std::string source;
+	size_t decoded = 0;
+	size_t processed = 0;
+	size_t dropped = 0;
+	double fps = 0.0;
+	// from the end of the decode to the end of the sink
+	double averageLatencyMs = 0.0;
+	double maxLatencyMs = 0.0;
+	bool finished = false;
+};
+
+// called on the tracking thread of the stream, frames of one stream arrive in order
+using StreamSink = std::function<void(size_t streamIndex, size_t frameIndex, const cv::Mat& frame, const std::vector<TrackingResult>& results)>;
+
+// headless tracking of many video sources at once: every stream decodes on its own thread and is tracked on another
+// one with its own Tracker, the full frame detections of all streams are batched per detector and the visual
+// trackers of all streams share one thread pool
+class MultiStreamTracker {
+public:
+	MultiStreamTracker(MultiStreamParameters params = MultiStreamParameters());
+	~MultiStreamTracker();
+
+	void AppendFaceDetector(std::shared_ptr<dl::FaceDetector> detector);
+	void AppendInstanceSegmentator(std::shared_ptr<dl::InstanceSegmentator> segmentator);
+	// source is a file, a stream url or the index of a camera, returns the index of the stream
+	size_t AddStream(const std::string& source);
+
+	void Start(const StreamSink& sink);
+	// asks the decode threads to stop, frames already decoded still reach the sink
+	void Stop();
+	// blocks until every stream is finished
+	void Wait();
+	// Start + Wait
+	void Run(const StreamSink& sink);
+
+	bool IsRunning() const { return m_running.load(); }
+	std::vector<StreamStatistics> GetStatistics() const;
+	// frames of all streams tracked per second since Start
+	double GetAggregateFps() const;
+	std::vector<dl::BatchingStatistics> GetBatchingStatistics() const;
+	void LogStatistics() const;
+
+private:
+	struct StreamFrame {
+		size_t index = 0;
+		std::chrono::steady_clock::time_point decodeTime;
+		cv::Mat frame;
+	};
+
+	using FrameQueue = base::SpscQueue<std::unique_ptr<StreamFrame>>;
+
+	struct Stream {
+		std::string source;
+		// camera or stream url, decided when the source is opened
+		bool live = false;
+		cv::VideoCapture capture;
+		std::unique_ptr<Tracker> tracker;
+		std::unique_ptr<FrameQueue> queue;
+		std::thread decodeThread;
+		std::thread trackThread;
+		std::atomic<size_t> decoded = 0;
+		std::atomic<size_t> processed = 0;
+		std::atomic<size_t> dropped = 0;
+		std::atomic<long long> totalNs = 0;
+		std::atomic<long long> maxNs = 0;
+		std::atomic<bool> finished = false;
+	};
+
+	bool Open(Stream& stream);
+	void DecodeLoop(Stream& stream);
+	void TrackLoop(size_t streamIndex, StreamSink sink);
+
+	MultiStreamParameters m_params;
+	std::vector<std::pair<dl::Object, std::shared_ptr<dl::BaseDetector>>> m_detectors;
+	std::vector<std::shared_ptr<dl::DetectionBatcher>> m_batchers;
+	std::shared_ptr<base::ThreadPool> m_pool;
+	std::vector<std::unique_ptr<Stream>> m_streams;
+	std::chrono::steady_clock::time_point m_startTime;
+	std::chrono::steady_clock::time_point m_endTime;
+	std::atomic<bool> m_stopRequested = false;
+	std::atomic<bool> m_running = false;
+	static std::shared_ptr<base::Logger> m_logger;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <tracking/track-associator.h>
+#include <opencv2/opencv.hpp>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace base {
+	class Logger;
+}
+
+namespace video {
+
+enum class RedetectionPolicy {
+	// full detection every interval frames
+	FIXED_INTERVAL = 1,
+	// full detection as soon as a track drifted from the box of its last detection, at the latest every interval frames
+	ADAPTIVE = 2,
+	// region detections of the tracks detected longest ago as long as they fit into the frame budget, the full
+	// detection waits for a frame with enough budget left
+	TIME_BUDGET = 3,
+	// region detection of one track per frame in turn, the full detection every interval frames finds new objects
+	STAGGERED = 4
+};
+
+struct RedetectionParameters {
+	RedetectionPolicy policy = RedetectionPolicy::FIXED_INTERVAL;
+	int interval = 30;
+	// ADAPTIVE does not detect the full frame again for a drifting track before this many frames
+	int minInterval = 5;
+	// ADAPTIVE: 1 - IoU between the current box of a track and the box of its last detection
+	float driftThreshold = 0.3f;
+	// TIME_BUDGET: milliseconds a frame may take including the detections, the full detection is forced after
+	// twice the interval
+	double frameBudgetMs = 33.0;
+	// region detections look at the box of the track grown by this fraction of its size on every side
+	float regionMargin = 0.5f;
+};
+
+// what to detect on the current frame, regionTracks are the ids of the tracks to look for in their own region
+struct RedetectionDecision {
+	bool full = false;
+	std::vector<int> regionTracks;
+};
+
+// decides per frame whether the tracks are detected again and spreads the detections over the frames according to
+// its policy, the detection times are fed back to estimate what fits into the frame budget
+class RedetectionScheduler {
+public:
+	RedetectionScheduler(const RedetectionParameters& params = RedetectionParameters())
+	: m_params(params) {}
+
+	void SetParameters(const RedetectionParameters& params) { m_params = params; }
+	const RedetectionParameters& GetParameters() const { return m_params; }
+
+	// called once per frame with the tracks after the visual tracker update, failed are the tracks whose visual
+	// tracker lost its object and elapsedMs the time the frame took so far
+	RedetectionDecision Schedule(const std::vector<TrackingResult>& tracks, const std::vector<int>& failed, double elapsedMs);
+	void OnFullDetection(const std::vector<TrackingResult>& tracks, double detectionMs);
+	void OnRegionDetection(int trackId, const cv::Rect& box, double detectionMs);
+	// forgets the last detection of a track that no longer exists
+	void OnTrackRemoved(int trackId) { m_detected.erase(trackId); }
+	// restarts the interval without detecting, e.g. when the scene did not change
+	void Postpone() { m_framesSinceDetection = 0; }
+	void Reset();
+
+	// box of the track grown by the region margin and clipped to the frame
+	cv::Rect CalculateRegion(const cv::Rect& box, const cv::Size& frameSize) const;
+	size_t GetFullDetectionCount() const { return m_fullDetections; }
+	size_t GetRegionDetectionCount() const { return m_regionDetections; }
+	void LogStatistics() const;
+
+private:
+	// box and frame of the last detection of a track
+	struct DetectedTrack {
+		cv::Rect box;
+		size_t frame = 0;
+	};
+
+	bool IsDrifting(const std::vector<TrackingResult>& tracks) const;
+	// tracks ordered by the frame of their last detection, the oldest first
+	std::vector<int> OrderByAge(const std::vector<TrackingResult>& tracks) const;
+	static double Smooth(double average, double value);
+
+	RedetectionParameters m_params;
+	std::map<int, DetectedTrack> m_detected;
+	size_t m_frame = 0;
+	int m_framesSinceDetection = 0;
+	// running averages of the detection times, 0 until the first detection was measured
+	double m_fullDetectionMs = 0.0;
+	double m_regionDetectionMs = 0.0;
+	size_t m_fullDetections = 0;
+	size_t m_regionDetections = 0;
+	static std::shared_ptr<base::Logger> m_logger;
+};
+
+}
\ No newline at end of file
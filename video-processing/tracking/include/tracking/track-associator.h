@@ -0,0 +1,89 @@
+#pragma once
+
+#include <object-detection/object-detection.h>
+#include <tracking/kalman-box-filter.h>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace video {
+
+// trackId stays the same for an object as long as its track lives, -1 for results that do not belong to a track
+struct TrackingResult {
+	cv::Rect bbox;
+	int trackId = -1;
+	std::optional<std::string> objClass;
+	std::optional<float> confidence;
+	std::optional<dl::AttributeEstimation> ageEstimation;
+	std::optional<dl::AttributeEstimation> genderEstimation;
+	std::optional<dl::AttributeEstimation> ethnicityEstimation;
+	std::optional<dl::SegmentationDrawingElement> drawingElement;
+};
+
+// ByteTrack style association in two stages: detections above highConfidence are matched first, the tracks left over
+// get a second chance with the detections above lowConfidence, a pair needs an IoU of at least iouThreshold
+// tracks without a detection or measurement for more than maxAge frames are removed
+struct AssociationParameters {
+	float iouThreshold = 0.3f;
+	float highConfidence = 0.6f;
+	float lowConfidence = 0.1f;
+	int maxAge = 30;
+};
+
+struct Track {
+	int id = -1;
+	KalmanBoxFilter filter;
+	TrackingResult result;
+	int hits = 0;
+	int timeSinceUpdate = 0;
+};
+
+// pairs of track id and detection index, created are the tracks started from unmatched detections and unmatched the
+// tracks no detection was found for
+struct AssociationResult {
+	std::vector<std::pair<int, size_t>> matches;
+	std::vector<std::pair<int, size_t>> created;
+	std::vector<int> unmatched;
+};
+
+// keeps one Kalman filtered track per object and assigns new detections to them with the Hungarian algorithm on
+// the IoU of the predicted boxes (SORT), the attributes of a track survive detections that do not carry them
+class TrackAssociator {
+public:
+	TrackAssociator() = default;
+
+	void SetParameters(const AssociationParameters& params) { m_params = params; }
+	const AssociationParameters& GetParameters() const { return m_params; }
+
+	// advances every track by one frame, returns the ids of the tracks removed because they aged out
+	std::vector<int> Predict();
+	// measurement of a single track from another source, e.g. a visual tracker
+	void Correct(int trackId, const cv::Rect& box);
+	AssociationResult Associate(const std::vector<TrackingResult>& detections);
+	// association of the detections found in one region of the frame, only the tracks centered in the region take
+	// part and no track is created since objects cut by the region border would start one
+	AssociationResult AssociateRegion(const std::vector<TrackingResult>& detections, const cv::Rect& region);
+	// starts a track from a result, returns its id
+	int AddTrack(const TrackingResult& result);
+	Track* FindTrack(int trackId);
+	// results of every track at its current box, labeled with the track id
+	std::vector<TrackingResult> GetResults() const;
+	const std::vector<Track>& GetTracks() const { return m_tracks; }
+	void Clear();
+
+private:
+	// both stages between the given tracks and all detections, the high confidence detections left over start
+	// tracks when create is set
+	AssociationResult Associate(const std::vector<TrackingResult>& detections, const std::vector<size_t>& tracks, bool create);
+	// one Hungarian round between the given tracks and detections, everything not matched is left over
+	void Match(const std::vector<size_t>& tracks, const std::vector<size_t>& detections, const std::vector<TrackingResult>& results,
+		std::vector<std::pair<size_t, size_t>>& matches, std::vector<size_t>& leftTracks, std::vector<size_t>& leftDetections) const;
+	static void UpdateTrack(Track& track, const TrackingResult& detection);
+
+	AssociationParameters m_params;
+	std::vector<Track> m_tracks;
+	int m_nextId = 1;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <opencv2/tracking.hpp>
+#include <opencv2/tracking/tracking.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace base {
+	class Logger;
+	class ThreadPool;
+}
+
+namespace video {
+
+enum class TrackerType {
+	BOOSTING = 1,
+	CSRT = 2,
+	GOTURN = 3,
+	KCF = 4,
+	MEDIANFLOW = 5,
+	MIL = 6,
+	MOSSE = 7,
+	TLD = 8
+};
+
+// update timings of a single visual tracker
+struct TrackerStatistics {
+	int trackId = -1;
+	TrackerType type = TrackerType::KCF;
+	size_t updates = 0;
+	size_t failures = 0;
+	double totalMs = 0.0;
+	double lastMs = 0.0;
+	double maxMs = 0.0;
+
+	double MeanMs() const { return updates ? totalMs / updates : 0.0; }
+};
+
+// owns one visual tracker per track id and updates all of them on a thread pool, a tracker that loses its object is
+// dropped on its own, the others keep running
+class TrackerManager {
+public:
+	// without a pool the manager creates one with a worker per hardware thread
+	explicit TrackerManager(std::shared_ptr<base::ThreadPool> pool = nullptr);
+
+	~TrackerManager() {}
+
+	static cv::Ptr<cv::Tracker> CreateTracker(TrackerType type);
+	static std::string ConvertTrackerTypeToString(TrackerType type);
+
+	// starts a tracker for the track, an existing one is replaced, returns false and drops the track if the tracker
+	// could not be initialized
+	bool Respawn(int trackId, TrackerType type, const cv::Mat& image, const cv::Rect& box);
+	void Remove(int trackId);
+	void Clear();
+	bool Contains(int trackId) const { return m_trackers.find(trackId) != m_trackers.end(); }
+	bool Empty() const { return m_trackers.empty(); }
+	size_t Size() const { return m_trackers.size(); }
+	// box the tracker of the track reported last, the initial box right after a respawn
+	cv::Rect GetBox(int trackId) const;
+
+	// updates all trackers in parallel, the boxes of the successful ones are returned per track id and the ids of
+	// the failed ones are appended to failed, the failed trackers are removed
+	std::map<int, cv::Rect> Update(const cv::Mat& image, std::vector<int>& failed);
+
+	// statistics of the live trackers
+	std::vector<TrackerStatistics> GetStatistics() const;
+	// statistics per tracker type, including the trackers that were removed already
+	std::map<TrackerType, TrackerStatistics> GetTypeStatistics() const;
+	void LogStatistics() const;
+
+private:
+	struct ManagedTracker {
+		cv::Ptr<cv::Tracker> tracker;
+		cv::Rect box;
+		TrackerStatistics statistics;
+		bool succeeded = false;
+	};
+
+	void Retire(const ManagedTracker& managed);
+
+	std::shared_ptr<base::ThreadPool> m_pool;
+	std::map<int, ManagedTracker> m_trackers;
+	// statistics of the removed trackers, folded per type
+	std::map<TrackerType, TrackerStatistics> m_retired;
+	static std::shared_ptr<base::Logger> m_logger;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <tracking/track-associator.h>
+#include <opencv2/opencv.hpp>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace base {
+	class Logger;
+}
+
+namespace video {
+
+// everything a sink gets for one frame, masks only match their boxes on the frames the tracks were detected on
+struct TrackingFrame {
+	size_t index = 0;
+	cv::Mat image;
+	std::vector<TrackingResult> results;
+	bool masksValid = false;
+};
+
+// consumer of the tracking results, called on the thread running the tracker in frame order
+class TrackingSink {
+public:
+	virtual ~TrackingSink() {}
+
+	// returns false to end the run
+	virtual bool Write(const TrackingFrame& frame) = 0;
+	// called once after the last frame
+	virtual void Close() {}
+};
+
+// draws the tracks the way Tracker::Run always showed them
+class TrackingRenderer {
+public:
+	static void Render(cv::Mat& image, const TrackingFrame& frame);
+};
+
+// one JSON object per frame and line: {"frame":0,"tracks":[{"id":1,"bbox":[x,y,w,h],"confidence":0.9,...}]}
+class JsonLinesSink : public TrackingSink {
+public:
+	JsonLinesSink(const std::string& path);
+
+	bool Write(const TrackingFrame& frame) override;
+	void Close() override;
+
+private:
+	std::ofstream m_file;
+	static std::shared_ptr<base::Logger> m_logger;
+};
+
+// compact track log in native byte order: the header "TRKL" followed by a uint32 version, then per frame a uint64
+// frame index and a uint32 track count followed by the tracks as int32 id, int32 x, y, width, height and a float32
+// confidence that is NaN when the detector gave none
+class BinaryTrackLogSink : public TrackingSink {
+public:
+	static constexpr uint32_t VERSION = 1;
+
+	BinaryTrackLogSink(const std::string& path);
+
+	bool Write(const TrackingFrame& frame) override;
+	void Close() override;
+
+private:
+	template<typename T>
+	void WriteValue(T value) { m_file.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+	std::ofstream m_file;
+	static std::shared_ptr<base::Logger> m_logger;
+};
+
+// renders the tracks into a video file, the writer is opened with the size of the first frame
+class VideoWriterSink : public TrackingSink {
+public:
+	VideoWriterSink(const std::string& path, double fps, int fourcc = cv::VideoWriter::fourcc('m', 'p', '4', 'v'));
+
+	bool Write(const TrackingFrame& frame) override;
+	void Close() override;
+
+private:
+	std::string m_path;
+	double m_fps;
+	int m_fourcc;
+	cv::VideoWriter m_writer;
+	cv::Mat m_drawImage;
+	static std::shared_ptr<base::Logger> m_logger;
+};
+
+// renders the tracks into a window, escape ends the run, waitMs 1 lets the frames through as fast as they come
+class DisplaySink : public TrackingSink {
+public:
+	DisplaySink(const std::string& windowName, int waitMs = 1)
+	: m_windowName(windowName), m_waitMs(waitMs) {}
+
+	bool Write(const TrackingFrame& frame) override;
+	void Close() override;
+
+private:
+	std::string m_windowName;
+	int m_waitMs;
+	cv::Mat m_drawImage;
+};
+
+}
\ No newline at end of file
@@ -3,63 +3,87 @@
 #include <face-detection/face-detection.h>
 #include <object-detection/object-detection.h>
 #include <instance-segmentation/instance-segmentation.h>
+#include <tracking/track-associator.h>
+#include <tracking/tracker-manager.h>
+#include <tracking/redetection-scheduler.h>
+#include <tracking/tracking-sink.h>
 #include <opencv2/opencv.hpp>
 #include <opencv2/tracking.hpp>
 #include <opencv2/tracking/tracking.hpp>
 #include <opencv2/core/ocl.hpp>
+#include <map>
 #include <optional>
 
 namespace base {
 	class Logger;
+	class ThreadPool;
 }
 
-namespace video {
-
-enum class TrackerType {
-	BOOSTING = 1,
-	CSRT = 2,
-	GOTURN = 3,
-	KCF = 4,
-	MEDIANFLOW = 5,
-	MIL = 6,
-	MOSSE = 7,
-	TLD = 8
-};
+namespace dl {
+	class DetectionBatcher;
+}
 
-struct TrackingResult {
-	cv::Rect bbox;
-	std::optional<std::string> objClass;
-	std::optional<float> confidence;
-	std::optional<std::string> ageEstimation;
-	std::optional<std::string> genderEstimation;
-	std::optional<std::string> ethnicityEstimation;
-	std::optional<dl::SegmentationDrawingElement> drawingElement;
-};
+namespace video {
 
+// every track is followed by a visual tracker between the detections and by a Kalman filter that keeps it going when
+// the visual tracker fails, redetections are associated with the tracks (see TrackAssociator) instead of replacing
+// them, so track ids stay stable and the attribute networks only run for new tracks
 class Tracker {
 public:
-	Tracker(int redetectSteps)
-	: m_redetectSteps(redetectSteps) {
-		m_multiTracker = cv::MultiTracker::create();
-	}
+	// redetectSteps is the interval of the redetection scheduler, the visual trackers are updated on the pool, trackers
+	// of several streams should share one
+	Tracker(int redetectSteps, std::shared_ptr<base::ThreadPool> pool = nullptr);
 
 	~Tracker() {}
 
 	void AppendFaceDetector(std::shared_ptr<dl::FaceDetector> detector);
 	void AppendInstanceSegmentator(std::shared_ptr<dl::InstanceSegmentator> segmentator);
+	// full frame detections of the appended detector the batcher belongs to go through the batcher, so that they
+	// share forward passes with other trackers
+	void SetDetectionBatcher(std::shared_ptr<dl::DetectionBatcher> batcher);
+	void SetAssociationParameters(const AssociationParameters& params) { m_associator.SetParameters(params); }
+	void SetRedetectionParameters(const RedetectionParameters& params) { m_scheduler.SetParameters(params); }
+	const RedetectionScheduler& GetRedetectionScheduler() const { return m_scheduler; }
+	// full detection including attributes, not associated with the tracks
 	std::vector<TrackingResult> ApplyDetectionOnSingleFrame(const cv::Mat& image);
+	// starts one track per result, followed by a visual tracker of the type with the same index
 	bool AppendTracker(std::vector<TrackerType> types, const cv::Mat& initialImage, std::vector<TrackingResult>& initialDetectionResults);
+	// results of all tracks for the frame, detects and associates when no track exists yet or the redetection
+	// scheduler asks for it, either on the full frame or in the regions of single tracks
 	std::vector<TrackingResult> PushFrame(cv::Mat& image);
+	// tracks every frame of the capture and hands the results to the sinks, nothing is drawn or shown unless a sink
+	// does it, so without a DisplaySink the frames run as fast as they are decoded, a sink returning false ends the run
+	void Run(cv::VideoCapture& cap, const std::vector<std::shared_ptr<TrackingSink>>& sinks);
+	// Run with a DisplaySink
 	void Run(cv::VideoCapture& cap);
+	// skips the periodic redetection while the scene has not changed since the last one, callers of the detectors
+	// gate their own streams through BaseDetector::DetectGated
+	void SetMotionGating(const dl::MotionGatingParameters& params);
+	const dl::MotionStatistics& GetMotionStatistics() const { return m_motionGate.GetStatistics(); }
+	const TrackerManager& GetTrackerManager() const { return m_trackerManager; }
 
 private:
+	static TrackingResult ConvertDetection(const dl::Detection& det);
+	// runs the detection stages without the attribute networks, associates the detections and estimates the
+	// attributes of the new tracks only
+	void DetectAndAssociate(const cv::Mat& image);
+	// detects in the region around one track and associates the detections with the tracks in that region
+	void DetectRegionAndAssociate(const cv::Mat& image, int trackId);
+	// keeps the visual tracker of a matched track unless it drifted away from the detection
+	void RefreshVisualTracker(int trackId, const cv::Mat& image, const cv::Rect& box);
+
 	std::vector<std::pair<dl::Object, std::shared_ptr<dl::BaseDetector>>> m_detectors;
-	cv::Ptr<cv::MultiTracker> m_multiTracker;
-	int m_redetectSteps;
-	int m_lastNumberOfObjects = 0;
+	// batcher per detector, null for the detectors running on their own
+	std::vector<std::shared_ptr<dl::DetectionBatcher>> m_batchers;
+	RedetectionScheduler m_scheduler;
+	// the last frame was detected and its results carry masks
 	bool m_segmentationDrawing = false;
-	std::vector<TrackingResult> m_lastTrackingResults;
-	std::vector<TrackerType> m_trackerTypes;
+	TrackAssociator m_associator;
+	TrackerManager m_trackerManager;
+	TrackerType m_trackerType = TrackerType::KCF;
+	// matched tracks keep their visual tracker unless it drifted below this IoU with the detection
+	float m_reinitializeIou = 0.5f;
+	dl::MotionGate m_motionGate;
 	static std::shared_ptr<base::Logger> m_logger;
 };
 
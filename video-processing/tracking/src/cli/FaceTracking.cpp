@@ -4,6 +4,20 @@
 #include <assertion/assertion.h>
 
 int main(int argc, char** argv) {
+	cxxopts::Options options("Face Tracking");
+	options.add_options()
+		("video", "Video path", cxxopts::value<std::string>()->default_value("../../../../video-processing/tracking/resource/Faces.mp4"))
+		("json", "JSON lines file receiving the tracks of every frame", cxxopts::value<std::string>()->default_value(""))
+		("log", "Binary track log", cxxopts::value<std::string>()->default_value(""))
+		("output", "Video file the rendered tracks are written to", cxxopts::value<std::string>()->default_value(""))
+		("headless", "Do not show the frames, the video runs as fast as it is decoded")
+		("h,help", "Print usage");
+
+	auto result = options.parse(argc, argv);
+	if (result.count("help")) {
+		std::cout << options.help() << std::endl;
+		exit(0);
+	}
 
 	dl::AgeEstimatorProperties ageProp = { dl::AgeEstimatorType::ONNX_200x200, "imageinput", "classoutput" };
 	dl::GenderEstimatorProperties genderProp = { dl::GenderEstimatorType::ONNX_200x200, "imageinput", "classoutput" };
@@ -12,20 +26,37 @@ int main(int argc, char** argv) {
 	auto detector = std::make_shared<dl::FaceDetector>(dl::FaceDetectorType::CAFFE_300x300, ageProp, genderProp, ethnicityProp);
 	dl::DetectionParameters params;
 	params.confidenceThreshold = 0.5;
+	// every duplicate box would get a tracker of its own
+	params.nmsParameters.mode = dl::NmsMode::HARD;
+	params.nmsParameters.iouThreshold = 0.4f;
 	detector->SetDetectionParameters(params);
 
 	auto tracker = std::make_shared<video::Tracker>(7);
 	tracker->AppendFaceDetector(detector);
-	
-	auto videoFile = "../../../../video-processing/tracking/resource/Faces.mp4";
+	// a static scene does not need the periodic redetection
+	dl::MotionGatingParameters motionParams;
+	motionParams.enabled = true;
+	tracker->SetMotionGating(motionParams);
 
-	cv::VideoCapture cap(videoFile);
+	cv::VideoCapture cap(result["video"].as<std::string>());
 	if (!cap.isOpened()) {
 		std::cout << "Error opening video file" << std::endl;
 		return -1;
 	}
 
-	tracker->Run(cap);
+	std::vector<std::shared_ptr<video::TrackingSink>> sinks;
+	if (!result["json"].as<std::string>().empty())
+		sinks.push_back(std::make_shared<video::JsonLinesSink>(result["json"].as<std::string>()));
+	if (!result["log"].as<std::string>().empty())
+		sinks.push_back(std::make_shared<video::BinaryTrackLogSink>(result["log"].as<std::string>()));
+	if (!result["output"].as<std::string>().empty()) {
+		double fps = cap.get(cv::CAP_PROP_FPS);
+		sinks.push_back(std::make_shared<video::VideoWriterSink>(result["output"].as<std::string>(), fps > 0.0 ? fps : 25.0));
+	}
+	if (!result.count("headless"))
+		sinks.push_back(std::make_shared<video::DisplaySink>("Webcam with Face Detections"));
+
+	tracker->Run(cap, sinks);
 
 	return 0;
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 int main(int argc, char** argv) {
 	auto segmentator = std::make_shared<dl::InstanceSegmentator>(dl::InstanceSegmentationType::TENSORFLOW_MASK_RCNN);
 	dl::DetectionParameters params;
+	params.renderMode = dl::RenderMode::BOXES_AND_MASKS;
 	params.inputName = "";
 	params.meanValues = { 0.0, 0.0, 0.0 };
 	params.outputDetectionName = "detection_out_final";
@@ -0,0 +1,69 @@
+#include <tracking/multi-stream-tracker.h>
+#include <object-detection/model-registry.h>
+#include <cxxopts.hpp>
+#include <file/file.h>
+#include <assertion/assertion.h>
+#include <iomanip>
+
+int main(int argc, char** argv) {
+	cxxopts::Options options("Multi Stream Tracking");
+	options.add_options()
+		("videos", "Comma separated video paths, stream urls or camera indices", cxxopts::value<std::vector<std::string>>()->default_value("../../../../video-processing/tracking/resource/Faces.mp4"))
+		("redetect", "Frames between two full frame detections of a stream", cxxopts::value<int>()->default_value("30"))
+		("batch", "Maximum number of frames in one detection batch", cxxopts::value<size_t>()->default_value("8"))
+		("wait", "Milliseconds a frame waits for others to fill its batch", cxxopts::value<double>()->default_value("5"))
+		("queue", "Frames a stream may decode ahead of its tracker", cxxopts::value<size_t>()->default_value("2"))
+		("block", "Block the decoding of cameras and stream urls instead of dropping frames while a tracker is behind, files always block")
+		("models", "Model manifest (root and resource overrides), the repository layout is used when empty", cxxopts::value<std::string>()->default_value(""))
+		("h,help", "Print usage");
+
+	auto result = options.parse(argc, argv);
+	if (result.count("help")) {
+		std::cout << options.help() << std::endl;
+		exit(0);
+	}
+
+	auto manifestPath = result["models"].as<std::string>();
+	if (!manifestPath.empty() && !dl::ModelRegistry::LoadManifest(manifestPath)) {
+		std::cout << "Error reading model manifest" << std::endl;
+		return -1;
+	}
+
+	dl::AgeEstimatorProperties ageProp = { dl::AgeEstimatorType::ONNX_200x200, "imageinput", "classoutput" };
+	dl::GenderEstimatorProperties genderProp = { dl::GenderEstimatorType::ONNX_200x200, "imageinput", "classoutput" };
+	dl::EthnicityEstimatorProperties ethnicityProp = { dl::EthnicityEstimatorType::ONNX_200x200, "imageinput", "classoutput" };
+
+	auto detector = std::make_shared<dl::FaceDetector>(dl::FaceDetectorType::CAFFE_300x300, ageProp, genderProp, ethnicityProp);
+	dl::DetectionParameters params;
+	params.confidenceThreshold = 0.5;
+	params.nmsParameters.mode = dl::NmsMode::HARD;
+	params.nmsParameters.iouThreshold = 0.4f;
+	detector->SetDetectionParameters(params);
+
+	video::MultiStreamParameters streamParams;
+	streamParams.redetectSteps = result["redetect"].as<int>();
+	streamParams.batchingParameters.maxBatchSize = result["batch"].as<size_t>();
+	streamParams.batchingParameters.maxWaitMs = result["wait"].as<double>();
+	streamParams.queueCapacity = result["queue"].as<size_t>();
+	streamParams.dropLiveFrames = result.count("block") == 0;
+
+	video::MultiStreamTracker tracker(streamParams);
+	tracker.AppendFaceDetector(detector);
+	for (const auto& video : result["videos"].as<std::vector<std::string>>())
+		tracker.AddStream(video);
+	tracker.Run(nullptr);
+
+	std::cout << std::left << std::setw(8) << "stream" << std::setw(10) << "frames" << std::setw(10) << "dropped"
+		<< std::setw(10) << "fps" << std::setw(12) << "avg [ms]" << std::setw(12) << "max [ms]" << std::endl;
+	auto statistics = tracker.GetStatistics();
+	for (size_t i = 0; i < statistics.size(); ++i) {
+		const auto& stream = statistics[i];
+		std::cout << std::left << std::setw(8) << i << std::setw(10) << stream.processed << std::setw(10) << stream.dropped
+			<< std::setw(10) << stream.fps << std::setw(12) << stream.averageLatencyMs << std::setw(12) << stream.maxLatencyMs << std::endl;
+	}
+	for (const auto& batching : tracker.GetBatchingStatistics())
+		std::cout << "Average detection batch: " << batching.averageBatchSize << " frames, " << batching.averageWaitMs << " ms wait" << std::endl;
+	std::cout << "Aggregate throughput: " << tracker.GetAggregateFps() << " FPS" << std::endl;
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <limits>
+
+#include "tracking/hungarian-solver.h"
+
+namespace video {
+
+void
+HungarianSolver::Solve(const std::vector<double>& cost, int rows, int cols, std::vector<int>& assignment) {
+	assignment.assign(std::max(rows, 0), -1);
+	if (rows <= 0 || cols <= 0)
+		return;
+
+	// the algorithm needs at most as many rows as columns, a wide view of a tall matrix is solved transposed
+	const bool transposed = rows > cols;
+	const int n = transposed ? cols : rows;
+	const int m = transposed ? rows : cols;
+	auto Cost = [&](int i, int j) {
+		return transposed ? cost[static_cast<size_t>(j) * cols + i] : cost[static_cast<size_t>(i) * cols + j];
+	};
+
+	// 1-based potentials u, v and the row p[j] matched to column j, column 0 is the virtual start
+	const double inf = std::numeric_limits<double>::infinity();
+	std::vector<double> u(n + 1, 0.0), v(m + 1, 0.0), minv(m + 1);
+	std::vector<int> p(m + 1, 0), way(m + 1, 0);
+	std::vector<char> used(m + 1);
+	for (int i = 1; i <= n; ++i) {
+		p[0] = i;
+		int j0 = 0;
+		std::fill(minv.begin(), minv.end(), inf);
+		std::fill(used.begin(), used.end(), 0);
+		do {
+			used[j0] = 1;
+			const int i0 = p[j0];
+			double delta = inf;
+			int j1 = 0;
+			for (int j = 1; j <= m; ++j) {
+				if (used[j])
+					continue;
+				const double current = Cost(i0 - 1, j - 1) - u[i0] - v[j];
+				if (current < minv[j]) {
+					minv[j] = current;
+					way[j] = j0;
+				}
+				if (minv[j] < delta) {
+					delta = minv[j];
+					j1 = j;
+				}
+			}
+			for (int j = 0; j <= m; ++j) {
+				if (used[j]) {
+					u[p[j]] += delta;
+					v[j] -= delta;
+				}
+				else {
+					minv[j] -= delta;
+				}
+			}
+			j0 = j1;
+		} while (p[j0] != 0);
+		// walk the augmenting path back to the start
+		do {
+			const int j1 = way[j0];
+			p[j0] = p[j1];
+			j0 = j1;
+		} while (j0);
+	}
+
+	for (int j = 1; j <= m; ++j) {
+		if (p[j] == 0)
+			continue;
+		if (transposed)
+			assignment[j - 1] = p[j] - 1;
+		else
+			assignment[p[j] - 1] = j - 1;
+	}
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include <opencv2/core.hpp>
+#include <opencv2/video.hpp>
+#include <algorithm>
+#include <cmath>
+
+#include "tracking/kalman-box-filter.h"
+
+namespace video {
+
+KalmanBoxFilter::KalmanBoxFilter(const cv::Rect& box)
+	: m_filter(7, 4, 0, CV_32F) {
+	// positions move with their velocities, area and ratio are measured directly
+	cv::setIdentity(m_filter.transitionMatrix);
+	m_filter.transitionMatrix.at<float>(0, 4) = 1.0f;
+	m_filter.transitionMatrix.at<float>(1, 5) = 1.0f;
+	m_filter.transitionMatrix.at<float>(2, 6) = 1.0f;
+	m_filter.measurementMatrix = cv::Mat::zeros(4, 7, CV_32F);
+	cv::setIdentity(m_filter.measurementMatrix);
+
+	// noise values of the SORT reference implementation, velocities start out unknown
+	cv::setIdentity(m_filter.measurementNoiseCov, cv::Scalar(1.0));
+	m_filter.measurementNoiseCov.at<float>(2, 2) = 10.0f;
+	m_filter.measurementNoiseCov.at<float>(3, 3) = 10.0f;
+	cv::setIdentity(m_filter.processNoiseCov, cv::Scalar(1.0));
+	m_filter.processNoiseCov.at<float>(4, 4) = 0.01f;
+	m_filter.processNoiseCov.at<float>(5, 5) = 0.01f;
+	m_filter.processNoiseCov.at<float>(6, 6) = 0.0001f;
+	cv::setIdentity(m_filter.errorCovPost, cv::Scalar(10.0));
+	for (int i = 4; i < 7; ++i)
+		m_filter.errorCovPost.at<float>(i, i) = 10000.0f;
+
+	m_filter.statePost = cv::Mat::zeros(7, 1, CV_32F);
+	auto measurement = ConvertBoxToMeasurement(box);
+	for (int i = 0; i < 4; ++i)
+		m_filter.statePost.at<float>(i) = measurement.at<float>(i);
+}
+
+cv::Rect
+KalmanBoxFilter::Predict() {
+	// the area must not shrink below zero
+	if (m_filter.statePost.at<float>(2) + m_filter.statePost.at<float>(6) <= 0.0f)
+		m_filter.statePost.at<float>(6) = 0.0f;
+	// predict also moves the estimate, so a track without a correction keeps coasting
+	m_filter.predict();
+	return GetBox();
+}
+
+void
+KalmanBoxFilter::Correct(const cv::Rect& box) {
+	m_filter.correct(ConvertBoxToMeasurement(box));
+}
+
+cv::Rect
+KalmanBoxFilter::GetBox() const {
+	return ConvertStateToBox(m_filter.statePost);
+}
+
+cv::Mat
+KalmanBoxFilter::ConvertBoxToMeasurement(const cv::Rect& box) {
+	cv::Mat measurement(4, 1, CV_32F);
+	measurement.at<float>(0) = box.x + box.width / 2.0f;
+	measurement.at<float>(1) = box.y + box.height / 2.0f;
+	measurement.at<float>(2) = static_cast<float>(box.area());
+	measurement.at<float>(3) = box.height > 0 ? static_cast<float>(box.width) / box.height : 1.0f;
+	return measurement;
+}
+
+cv::Rect
+KalmanBoxFilter::ConvertStateToBox(const cv::Mat& state) {
+	const float area = std::max(state.at<float>(2), 0.0f);
+	const float ratio = std::max(state.at<float>(3), 1e-3f);
+	const float width = std::sqrt(area * ratio);
+	const float height = width > 0.0f ? area / width : 0.0f;
+	return cv::Rect(cvRound(state.at<float>(0) - width / 2.0f), cvRound(state.at<float>(1) - height / 2.0f), cvRound(width), cvRound(height));
+}
+
+}
\ No newline at end of file
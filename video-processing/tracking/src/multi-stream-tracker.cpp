@@ -0,0 +1,255 @@
+#include <logger/logger.h>
+#include <assertion/assertion.h>
+#include <concurrency/thread-pool.h>
+
+#include <algorithm>
+#include <cctype>
+#include <exception>
+#include <sstream>
+
+#include "tracking/multi-stream-tracker.h"
+
+std::shared_ptr<base::Logger> video::MultiStreamTracker::m_logger = std::make_shared<base::Logger>();
+
+namespace video {
+
+MultiStreamTracker::MultiStreamTracker(MultiStreamParameters params)
+	: m_params(params) {
+	ASSERT((m_params.queueCapacity > 0), "Multi stream tracker queue capacity must be positive", base::Logger::Severity::Error);
+}
+
+MultiStreamTracker::~MultiStreamTracker() {
+	Stop();
+	Wait();
+}
+
+void
+MultiStreamTracker::AppendFaceDetector(std::shared_ptr<dl::FaceDetector> detector) {
+	m_detectors.emplace_back(dl::Object::FACE, detector);
+}
+
+void
+MultiStreamTracker::AppendInstanceSegmentator(std::shared_ptr<dl::InstanceSegmentator> segmentator) {
+	m_detectors.emplace_back(dl::Object::INSTANCE_SEGMENTATION, segmentator);
+}
+
+size_t
+MultiStreamTracker::AddStream(const std::string& source) {
+	ASSERT((!m_running.load()), "Streams can not be added while the multi stream tracker is running", base::Logger::Severity::Error);
+	auto stream = std::make_unique<Stream>();
+	stream->source = source;
+	m_streams.emplace_back(std::move(stream));
+	return m_streams.size() - 1;
+}
+
+void
+MultiStreamTracker::Start(const StreamSink& sink) {
+	ASSERT((!m_running.load()), "Multi stream tracker is already running", base::Logger::Severity::Error);
+	ASSERT((!m_detectors.empty()), "Multi stream tracker needs a detector", base::Logger::Severity::Error);
+	m_running = true;
+	m_stopRequested = false;
+
+	// one batcher per detector collects the full frame detections of every stream
+	m_batchers.clear();
+	for (const auto& detector : m_detectors)
+		m_batchers.emplace_back(std::make_shared<dl::DetectionBatcher>(detector.second, m_params.batchingParameters));
+	m_pool = std::make_shared<base::ThreadPool>(m_params.trackerThreads);
+
+	auto redetection = m_params.redetectionParameters;
+	redetection.interval = m_params.redetectSteps;
+	for (auto& stream : m_streams) {
+		stream->tracker = std::make_unique<Tracker>(m_params.redetectSteps, m_pool);
+		for (const auto& detector : m_detectors) {
+			if (detector.first == dl::Object::FACE)
+				stream->tracker->AppendFaceDetector(std::static_pointer_cast<dl::FaceDetector>(detector.second));
+			else
+				stream->tracker->AppendInstanceSegmentator(std::static_pointer_cast<dl::InstanceSegmentator>(detector.second));
+		}
+		for (const auto& batcher : m_batchers)
+			stream->tracker->SetDetectionBatcher(batcher);
+		stream->tracker->SetRedetectionParameters(redetection);
+		stream->tracker->SetAssociationParameters(m_params.associationParameters);
+		// closed queues can not be reused, every run gets fresh ones
+		stream->queue = std::make_unique<FrameQueue>(m_params.queueCapacity);
+		stream->decoded = 0;
+		stream->processed = 0;
+		stream->dropped = 0;
+		stream->totalNs = 0;
+		stream->maxNs = 0;
+		stream->finished = false;
+	}
+
+	m_startTime = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < m_streams.size(); ++i) {
+		auto& stream = *m_streams[i];
+		stream.decodeThread = std::thread(&MultiStreamTracker::DecodeLoop, this, std::ref(stream));
+		stream.trackThread = std::thread(&MultiStreamTracker::TrackLoop, this, i, sink);
+	}
+}
+
+void
+MultiStreamTracker::Stop() {
+	m_stopRequested = true;
+}
+
+void
+MultiStreamTracker::Wait() {
+	for (auto& stream : m_streams) {
+		if (stream->decodeThread.joinable())
+			stream->decodeThread.join();
+		if (stream->trackThread.joinable())
+			stream->trackThread.join();
+	}
+	if (m_running.load())
+		m_endTime = std::chrono::steady_clock::now();
+	m_running = false;
+}
+
+void
+MultiStreamTracker::Run(const StreamSink& sink) {
+	Start(sink);
+	Wait();
+}
+
+std::vector<StreamStatistics>
+MultiStreamTracker::GetStatistics() const {
+	auto end = m_running.load() ? std::chrono::steady_clock::now() : m_endTime;
+	double seconds = std::chrono::duration<double>(end - m_startTime).count();
+	std::vector<StreamStatistics> retVal;
+	for (const auto& stream : m_streams) {
+		StreamStatistics stats;
+		stats.source = stream->source;
+		stats.decoded = stream->decoded.load();
+		stats.processed = stream->processed.load();
+		stats.dropped = stream->dropped.load();
+		stats.finished = stream->finished.load();
+		if (seconds > 0.0)
+			stats.fps = stats.processed / seconds;
+		if (stats.processed > 0)
+			stats.averageLatencyMs = static_cast<double>(stream->totalNs.load()) / stats.processed / 1e6;
+		stats.maxLatencyMs = static_cast<double>(stream->maxNs.load()) / 1e6;
+		retVal.push_back(stats);
+	}
+	return retVal;
+}
+
+double
+MultiStreamTracker::GetAggregateFps() const {
+	double fps = 0.0;
+	for (const auto& stats : GetStatistics())
+		fps += stats.fps;
+	return fps;
+}
+
+std::vector<dl::BatchingStatistics>
+MultiStreamTracker::GetBatchingStatistics() const {
+	std::vector<dl::BatchingStatistics> retVal;
+	for (const auto& batcher : m_batchers)
+		retVal.push_back(batcher->GetStatistics());
+	return retVal;
+}
+
+void
+MultiStreamTracker::LogStatistics() const {
+	auto statistics = GetStatistics();
+	for (size_t i = 0; i < statistics.size(); ++i) {
+		const auto& stats = statistics[i];
+		std::stringstream ss;
+		ss << "Stream " << i << " (" << stats.source << "): " << stats.processed << " frames, " << stats.dropped << " dropped, "
+			<< stats.fps << " fps, latency mean " << stats.averageLatencyMs << " ms, max " << stats.maxLatencyMs << " ms";
+		m_logger->LogInfo(ss.str().c_str());
+	}
+	for (const auto& batching : GetBatchingStatistics()) {
+		std::stringstream ss;
+		ss << "Detection batches: " << batching.batches << " for " << batching.requests << " frames, mean size "
+			<< batching.averageBatchSize << ", mean wait " << batching.averageWaitMs << " ms";
+		m_logger->LogInfo(ss.str().c_str());
+	}
+	std::string msg = "Aggregate tracking rate: " + std::to_string(GetAggregateFps()) + " fps over " + std::to_string(m_streams.size()) + " streams";
+	m_logger->LogInfo(msg.c_str());
+}
+
+bool
+MultiStreamTracker::Open(Stream& stream) {
+	stream.capture.release();
+	const auto& source = stream.source;
+	bool camera = !source.empty() && std::all_of(source.begin(), source.end(), [](unsigned char c) { return std::isdigit(c); });
+	stream.live = camera || source.find("://") != std::string::npos;
+	if (camera)
+		stream.capture.open(std::stoi(source));
+	else
+		stream.capture.open(source);
+	if (!stream.capture.isOpened()) {
+		std::string logMsg = "Could not open stream " + source;
+		m_logger->LogError(logMsg.c_str());
+		return false;
+	}
+	return true;
+}
+
+void
+MultiStreamTracker::DecodeLoop(Stream& stream) {
+	auto& output = *stream.queue;
+	if (Open(stream)) {
+		size_t index = 0;
+		while (!m_stopRequested.load()) {
+			auto frame = std::make_unique<StreamFrame>();
+			if (!stream.capture.read(frame->frame) || frame->frame.empty())
+				break;
+			frame->index = index++;
+			frame->decodeTime = std::chrono::steady_clock::now();
+			stream.decoded.fetch_add(1, std::memory_order_relaxed);
+			if (!stream.live || !m_params.dropLiveFrames) {
+				// a file has no frame rate to keep up with, every frame is tracked
+				if (!output.Push(std::move(frame)))
+					break;
+			}
+			else if (!output.TryPush(std::move(frame))) {
+				// a live source keeps going, the newest frame is skipped while the tracker of the stream is behind
+				stream.dropped.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		stream.capture.release();
+	}
+	output.Close();
+}
+
+void
+MultiStreamTracker::TrackLoop(size_t streamIndex, StreamSink sink) {
+	auto& stream = *m_streams[streamIndex];
+	// the batcher hands on whatever the detector threw, nothing may leave the stream thread
+	auto Drop = [&stream, streamIndex](const StreamFrame& frame, const std::string& reason) {
+		std::string logMsg = "Stream " + std::to_string(streamIndex) + " frame " + std::to_string(frame.index) + " dropped: " + reason;
+		m_logger->LogError(logMsg.c_str());
+		stream.dropped.fetch_add(1, std::memory_order_relaxed);
+	};
+
+	std::unique_ptr<StreamFrame> frame;
+	while (stream.queue->Pop(frame)) {
+		std::vector<TrackingResult> results;
+		try {
+			results = stream.tracker->PushFrame(frame->frame);
+		}
+		catch (const std::exception& e) {
+			Drop(*frame, e.what());
+			continue;
+		}
+		catch (...) {
+			Drop(*frame, "unknown exception");
+			continue;
+		}
+		if (sink)
+			sink(streamIndex, frame->index, frame->frame, results);
+
+		auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - frame->decodeTime).count();
+		stream.processed.fetch_add(1, std::memory_order_relaxed);
+		stream.totalNs.fetch_add(ns, std::memory_order_relaxed);
+		auto currentMax = stream.maxNs.load(std::memory_order_relaxed);
+		while (ns > currentMax && !stream.maxNs.compare_exchange_weak(currentMax, ns, std::memory_order_relaxed));
+	}
+	stream.finished = true;
+	std::string logMsg = "Stream " + std::to_string(streamIndex) + " (" + stream.source + ") finished";
+	m_logger->LogInfo(logMsg.c_str());
+}
+
+}
\ No newline at end of file
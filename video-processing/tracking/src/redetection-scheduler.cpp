@@ -0,0 +1,150 @@
+#include <logger/logger.h>
+#include <object-detection/non-maximum-suppression.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include "tracking/redetection-scheduler.h"
+
+std::shared_ptr<base::Logger> video::RedetectionScheduler::m_logger = std::make_shared<base::Logger>();
+
+namespace video {
+
+RedetectionDecision
+RedetectionScheduler::Schedule(const std::vector<TrackingResult>& tracks, const std::vector<int>& failed, double elapsedMs) {
+	m_frame++;
+	m_framesSinceDetection++;
+	RedetectionDecision decision;
+	const bool due = m_framesSinceDetection >= m_params.interval;
+
+	switch (m_params.policy) {
+	case RedetectionPolicy::FIXED_INTERVAL:
+	{
+		decision.full = due || !failed.empty();
+		break;
+	}
+	case RedetectionPolicy::ADAPTIVE:
+	{
+		decision.full = due || !failed.empty() || (m_framesSinceDetection >= m_params.minInterval && IsDrifting(tracks));
+		break;
+	}
+	case RedetectionPolicy::TIME_BUDGET:
+	{
+		double remaining = m_params.frameBudgetMs - elapsedMs;
+		if (m_framesSinceDetection >= 2 * m_params.interval || (due && m_fullDetectionMs <= remaining)) {
+			decision.full = true;
+			break;
+		}
+		// the failed tracks are looked for first, a region detection that was never measured is tried once
+		std::vector<int> candidates = failed;
+		for (int trackId : OrderByAge(tracks))
+			if (std::find(failed.begin(), failed.end(), trackId) == failed.end())
+				candidates.push_back(trackId);
+		for (int trackId : candidates) {
+			if (m_regionDetectionMs > remaining)
+				break;
+			decision.regionTracks.push_back(trackId);
+			if (m_regionDetectionMs <= 0.0)
+				break;
+			remaining -= m_regionDetectionMs;
+		}
+		break;
+	}
+	case RedetectionPolicy::STAGGERED:
+	{
+		decision.full = due;
+		if (decision.full)
+			break;
+		if (!failed.empty()) {
+			decision.regionTracks.push_back(failed.front());
+		}
+		else {
+			auto ordered = OrderByAge(tracks);
+			if (!ordered.empty())
+				decision.regionTracks.push_back(ordered.front());
+		}
+		break;
+	}
+	default: break;
+	}
+	return decision;
+}
+
+void
+RedetectionScheduler::OnFullDetection(const std::vector<TrackingResult>& tracks, double detectionMs) {
+	m_detected.clear();
+	for (const auto& track : tracks)
+		m_detected[track.trackId] = { track.bbox, m_frame };
+	m_framesSinceDetection = 0;
+	m_fullDetectionMs = Smooth(m_fullDetectionMs, detectionMs);
+	m_fullDetections++;
+}
+
+void
+RedetectionScheduler::OnRegionDetection(int trackId, const cv::Rect& box, double detectionMs) {
+	m_detected[trackId] = { box, m_frame };
+	m_regionDetectionMs = Smooth(m_regionDetectionMs, detectionMs);
+	m_regionDetections++;
+}
+
+void
+RedetectionScheduler::Reset() {
+	m_detected.clear();
+	m_frame = 0;
+	m_framesSinceDetection = 0;
+	m_fullDetectionMs = 0.0;
+	m_regionDetectionMs = 0.0;
+	m_fullDetections = 0;
+	m_regionDetections = 0;
+}
+
+cv::Rect
+RedetectionScheduler::CalculateRegion(const cv::Rect& box, const cv::Size& frameSize) const {
+	const int marginX = static_cast<int>(box.width * m_params.regionMargin);
+	const int marginY = static_cast<int>(box.height * m_params.regionMargin);
+	cv::Rect region(box.x - marginX, box.y - marginY, box.width + 2 * marginX, box.height + 2 * marginY);
+	return region & cv::Rect(cv::Point(0, 0), frameSize);
+}
+
+void
+RedetectionScheduler::LogStatistics() const {
+	std::stringstream ss;
+	ss << "Redetections over " << m_frame << " frames: " << m_fullDetections << " full (" << m_fullDetectionMs << " ms), "
+		<< m_regionDetections << " region (" << m_regionDetectionMs << " ms)";
+	m_logger->LogInfo(ss.str().c_str());
+}
+
+bool
+RedetectionScheduler::IsDrifting(const std::vector<TrackingResult>& tracks) const {
+	for (const auto& track : tracks) {
+		auto it = m_detected.find(track.trackId);
+		if (it == m_detected.end())
+			continue;
+		if (1.0f - dl::NonMaximumSuppression::IntersectionOverUnion(track.bbox, it->second.box) >= m_params.driftThreshold)
+			return true;
+	}
+	return false;
+}
+
+std::vector<int>
+RedetectionScheduler::OrderByAge(const std::vector<TrackingResult>& tracks) const {
+	std::vector<std::pair<size_t, int>> ages;
+	ages.reserve(tracks.size());
+	for (const auto& track : tracks) {
+		auto it = m_detected.find(track.trackId);
+		ages.emplace_back(it != m_detected.end() ? it->second.frame : 0, track.trackId);
+	}
+	std::stable_sort(ages.begin(), ages.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+	std::vector<int> ordered;
+	ordered.reserve(ages.size());
+	for (const auto& age : ages)
+		ordered.push_back(age.second);
+	return ordered;
+}
+
+double
+RedetectionScheduler::Smooth(double average, double value) {
+	return average <= 0.0 ? value : 0.8 * average + 0.2 * value;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include <object-detection/non-maximum-suppression.h>
+#include <algorithm>
+
+#include "tracking/track-associator.h"
+#include "tracking/hungarian-solver.h"
+
+namespace video {
+
+std::vector<int>
+TrackAssociator::Predict() {
+	std::vector<int> removed;
+	for (auto& track : m_tracks) {
+		track.result.bbox = track.filter.Predict();
+		track.timeSinceUpdate++;
+		if (track.timeSinceUpdate > m_params.maxAge)
+			removed.push_back(track.id);
+	}
+	m_tracks.erase(std::remove_if(m_tracks.begin(), m_tracks.end(), [this](const Track& track) {
+		return track.timeSinceUpdate > m_params.maxAge;
+	}), m_tracks.end());
+	return removed;
+}
+
+void
+TrackAssociator::Correct(int trackId, const cv::Rect& box) {
+	auto track = FindTrack(trackId);
+	if (!track)
+		return;
+	track->filter.Correct(box);
+	track->result.bbox = box;
+	track->timeSinceUpdate = 0;
+}
+
+AssociationResult
+TrackAssociator::Associate(const std::vector<TrackingResult>& detections) {
+	std::vector<size_t> tracks(m_tracks.size());
+	for (size_t i = 0; i < tracks.size(); ++i)
+		tracks[i] = i;
+	return Associate(detections, tracks, true);
+}
+
+AssociationResult
+TrackAssociator::AssociateRegion(const std::vector<TrackingResult>& detections, const cv::Rect& region) {
+	std::vector<size_t> tracks;
+	for (size_t i = 0; i < m_tracks.size(); ++i) {
+		const auto& box = m_tracks[i].result.bbox;
+		if (region.contains(cv::Point(box.x + box.width / 2, box.y + box.height / 2)))
+			tracks.push_back(i);
+	}
+	return Associate(detections, tracks, false);
+}
+
+AssociationResult
+TrackAssociator::Associate(const std::vector<TrackingResult>& detections, const std::vector<size_t>& tracks, bool create) {
+	AssociationResult retVal;
+	// detections without a confidence are trusted like confident ones
+	std::vector<size_t> high, low;
+	for (size_t i = 0; i < detections.size(); ++i) {
+		const float confidence = detections[i].confidence.value_or(1.0f);
+		if (confidence >= m_params.highConfidence)
+			high.push_back(i);
+		else if (confidence >= m_params.lowConfidence)
+			low.push_back(i);
+	}
+
+	std::vector<std::pair<size_t, size_t>> matches;
+	std::vector<size_t> leftTracks, leftHigh, finalTracks, leftLow;
+	Match(tracks, high, detections, matches, leftTracks, leftHigh);
+	// weak detections only confirm tracks, e.g. a partly occluded face, they never start a track
+	Match(leftTracks, low, detections, matches, finalTracks, leftLow);
+
+	for (const auto& [track, detection] : matches) {
+		UpdateTrack(m_tracks[track], detections[detection]);
+		retVal.matches.emplace_back(m_tracks[track].id, detection);
+	}
+	for (size_t track : finalTracks)
+		retVal.unmatched.push_back(m_tracks[track].id);
+	if (!create)
+		return retVal;
+	for (size_t detection : leftHigh)
+		retVal.created.emplace_back(AddTrack(detections[detection]), detection);
+	return retVal;
+}
+
+int
+TrackAssociator::AddTrack(const TrackingResult& result) {
+	Track track;
+	track.id = m_nextId++;
+	track.filter = KalmanBoxFilter(result.bbox);
+	track.result = result;
+	track.result.trackId = track.id;
+	track.hits = 1;
+	m_tracks.emplace_back(std::move(track));
+	return m_tracks.back().id;
+}
+
+Track*
+TrackAssociator::FindTrack(int trackId) {
+	auto it = std::find_if(m_tracks.begin(), m_tracks.end(), [trackId](const Track& track) { return track.id == trackId; });
+	return it != m_tracks.end() ? &(*it) : nullptr;
+}
+
+std::vector<TrackingResult>
+TrackAssociator::GetResults() const {
+	std::vector<TrackingResult> retVal;
+	retVal.reserve(m_tracks.size());
+	for (const auto& track : m_tracks)
+		retVal.push_back(track.result);
+	return retVal;
+}
+
+void
+TrackAssociator::Clear() {
+	m_tracks.clear();
+}
+
+void
+TrackAssociator::Match(const std::vector<size_t>& tracks, const std::vector<size_t>& detections, const std::vector<TrackingResult>& results,
+	std::vector<std::pair<size_t, size_t>>& matches, std::vector<size_t>& leftTracks, std::vector<size_t>& leftDetections) const {
+	leftTracks.clear();
+	leftDetections.clear();
+	if (tracks.empty() || detections.empty()) {
+		leftTracks = tracks;
+		leftDetections = detections;
+		return;
+	}
+
+	const int rows = static_cast<int>(tracks.size());
+	const int cols = static_cast<int>(detections.size());
+	std::vector<double> cost(static_cast<size_t>(rows) * cols);
+	for (int i = 0; i < rows; ++i)
+		for (int j = 0; j < cols; ++j)
+			cost[static_cast<size_t>(i) * cols + j] = 1.0 - dl::NonMaximumSuppression::IntersectionOverUnion(m_tracks[tracks[i]].result.bbox, results[detections[j]].bbox);
+	std::vector<int> assignment;
+	HungarianSolver::Solve(cost, rows, cols, assignment);
+
+	// the assignment is complete, pairs that barely overlap are split up again
+	std::vector<char> detectionMatched(cols, 0);
+	for (int i = 0; i < rows; ++i) {
+		const int j = assignment[i];
+		if (j >= 0 && 1.0 - cost[static_cast<size_t>(i) * cols + j] >= m_params.iouThreshold) {
+			matches.emplace_back(tracks[i], detections[j]);
+			detectionMatched[j] = 1;
+		}
+		else {
+			leftTracks.push_back(tracks[i]);
+		}
+	}
+	for (int j = 0; j < cols; ++j)
+		if (!detectionMatched[j])
+			leftDetections.push_back(detections[j]);
+}
+
+void
+TrackAssociator::UpdateTrack(Track& track, const TrackingResult& detection) {
+	track.filter.Correct(detection.bbox);
+	track.hits++;
+	track.timeSinceUpdate = 0;
+	auto& result = track.result;
+	result.bbox = detection.bbox;
+	if (detection.confidence.has_value())
+		result.confidence = detection.confidence;
+	if (detection.objClass.has_value())
+		result.objClass = detection.objClass;
+	if (detection.ageEstimation.has_value())
+		result.ageEstimation = detection.ageEstimation;
+	if (detection.genderEstimation.has_value())
+		result.genderEstimation = detection.genderEstimation;
+	if (detection.ethnicityEstimation.has_value())
+		result.ethnicityEstimation = detection.ethnicityEstimation;
+	if (detection.drawingElement.has_value())
+		result.drawingElement = detection.drawingElement;
+}
+
+}
\ No newline at end of file
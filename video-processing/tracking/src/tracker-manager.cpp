@@ -0,0 +1,184 @@
+#include <logger/logger.h>
+#include <concurrency/thread-pool.h>
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+#include "tracking/tracker-manager.h"
+
+std::shared_ptr<base::Logger> video::TrackerManager::m_logger = std::make_shared<base::Logger>();
+
+namespace video {
+
+TrackerManager::TrackerManager(std::shared_ptr<base::ThreadPool> pool)
+	: m_pool(pool ? std::move(pool) : std::make_shared<base::ThreadPool>()) {}
+
+cv::Ptr<cv::Tracker>
+TrackerManager::CreateTracker(TrackerType type) {
+	switch (type) {
+	case TrackerType::BOOSTING: return cv::TrackerBoosting::create();
+	case TrackerType::CSRT: return cv::TrackerCSRT::create();
+	case TrackerType::GOTURN: return cv::TrackerGOTURN::create();
+	case TrackerType::KCF: return cv::TrackerKCF::create();
+	case TrackerType::MEDIANFLOW: return cv::TrackerMedianFlow::create();
+	case TrackerType::MIL: return cv::TrackerMIL::create();
+	case TrackerType::MOSSE: return cv::TrackerMOSSE::create();
+	case TrackerType::TLD: return cv::TrackerTLD::create();
+	default: return nullptr;
+	}
+}
+
+std::string
+TrackerManager::ConvertTrackerTypeToString(TrackerType type) {
+	switch (type) {
+	case TrackerType::BOOSTING: return "boosting";
+	case TrackerType::CSRT: return "csrt";
+	case TrackerType::GOTURN: return "goturn";
+	case TrackerType::KCF: return "kcf";
+	case TrackerType::MEDIANFLOW: return "medianflow";
+	case TrackerType::MIL: return "mil";
+	case TrackerType::MOSSE: return "mosse";
+	case TrackerType::TLD: return "tld";
+	default: return "unknown";
+	}
+}
+
+bool
+TrackerManager::Respawn(int trackId, TrackerType type, const cv::Mat& image, const cv::Rect& box) {
+	Remove(trackId);
+	ManagedTracker managed;
+	managed.tracker = CreateTracker(type);
+	managed.box = box;
+	managed.statistics.trackId = trackId;
+	managed.statistics.type = type;
+	if (!managed.tracker || !managed.tracker->init(image, box)) {
+		std::string msg = "Could not initialize " + ConvertTrackerTypeToString(type) + " tracker for track " + std::to_string(trackId);
+		m_logger->LogWarn(msg.c_str());
+		return false;
+	}
+	m_trackers.emplace(trackId, std::move(managed));
+	return true;
+}
+
+void
+TrackerManager::Remove(int trackId) {
+	auto it = m_trackers.find(trackId);
+	if (it == m_trackers.end())
+		return;
+	Retire(it->second);
+	m_trackers.erase(it);
+}
+
+void
+TrackerManager::Clear() {
+	for (const auto& [trackId, managed] : m_trackers)
+		Retire(managed);
+	m_trackers.clear();
+}
+
+cv::Rect
+TrackerManager::GetBox(int trackId) const {
+	auto it = m_trackers.find(trackId);
+	return it != m_trackers.end() ? it->second.box : cv::Rect();
+}
+
+std::map<int, cv::Rect>
+TrackerManager::Update(const cv::Mat& image, std::vector<int>& failed) {
+	std::map<int, cv::Rect> boxes;
+	if (m_trackers.empty())
+		return boxes;
+
+	// map nodes do not move, every task only touches its own tracker
+	std::vector<ManagedTracker*> trackers;
+	trackers.reserve(m_trackers.size());
+	for (auto& [trackId, managed] : m_trackers)
+		trackers.push_back(&managed);
+
+	m_pool->ParallelFor(trackers.size(), [&image, &trackers](size_t i) {
+		auto& managed = *trackers[i];
+		auto start = std::chrono::steady_clock::now();
+		cv::Rect2d box;
+		// a tracker that throws, e.g. on a box that left the frame, is lost like one that fails, the others still run
+		try {
+			managed.succeeded = managed.tracker->update(image, box);
+		}
+		catch (const cv::Exception&) {
+			managed.succeeded = false;
+		}
+		auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		if (managed.succeeded)
+			managed.box = box;
+		auto& statistics = managed.statistics;
+		statistics.updates++;
+		statistics.totalMs += elapsed;
+		statistics.lastMs = elapsed;
+		statistics.maxMs = std::max(statistics.maxMs, elapsed);
+	});
+
+	for (auto it = m_trackers.begin(); it != m_trackers.end();) {
+		if (it->second.succeeded) {
+			boxes.emplace(it->first, it->second.box);
+			++it;
+		}
+		else {
+			it->second.statistics.failures++;
+			failed.push_back(it->first);
+			Retire(it->second);
+			it = m_trackers.erase(it);
+		}
+	}
+	return boxes;
+}
+
+std::vector<TrackerStatistics>
+TrackerManager::GetStatistics() const {
+	std::vector<TrackerStatistics> statistics;
+	statistics.reserve(m_trackers.size());
+	for (const auto& [trackId, managed] : m_trackers)
+		statistics.push_back(managed.statistics);
+	return statistics;
+}
+
+std::map<TrackerType, TrackerStatistics>
+TrackerManager::GetTypeStatistics() const {
+	auto statistics = m_retired;
+	for (const auto& [trackId, managed] : m_trackers) {
+		auto& folded = statistics[managed.statistics.type];
+		folded.type = managed.statistics.type;
+		folded.updates += managed.statistics.updates;
+		folded.failures += managed.statistics.failures;
+		folded.totalMs += managed.statistics.totalMs;
+		folded.maxMs = std::max(folded.maxMs, managed.statistics.maxMs);
+	}
+	return statistics;
+}
+
+void
+TrackerManager::LogStatistics() const {
+	for (const auto& [type, statistics] : GetTypeStatistics()) {
+		std::stringstream ss;
+		ss << ConvertTrackerTypeToString(type) << " trackers: " << statistics.updates << " updates, "
+			<< statistics.failures << " failures, mean " << statistics.MeanMs() << " ms, max " << statistics.maxMs << " ms";
+		m_logger->LogInfo(ss.str().c_str());
+	}
+	for (const auto& statistics : GetStatistics()) {
+		std::stringstream ss;
+		ss << "Track " << statistics.trackId << " (" << ConvertTrackerTypeToString(statistics.type) << "): mean "
+			<< statistics.MeanMs() << " ms, last " << statistics.lastMs << " ms";
+		m_logger->LogDebug(ss.str().c_str());
+	}
+}
+
+void
+TrackerManager::Retire(const ManagedTracker& managed) {
+	auto& folded = m_retired[managed.statistics.type];
+	folded.type = managed.statistics.type;
+	folded.updates += managed.statistics.updates;
+	folded.failures += managed.statistics.failures;
+	folded.totalMs += managed.statistics.totalMs;
+	folded.lastMs = managed.statistics.lastMs;
+	folded.maxMs = std::max(folded.maxMs, managed.statistics.maxMs);
+}
+
+}
\ No newline at end of file
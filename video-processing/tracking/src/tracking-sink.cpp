@@ -0,0 +1,155 @@
+#include <logger/logger.h>
+#include <string/string.h>
+#include <object-detection/detection-renderer.h>
+
+#include <limits>
+
+#include "tracking/tracking-sink.h"
+
+std::shared_ptr<base::Logger> video::JsonLinesSink::m_logger = std::make_shared<base::Logger>();
+std::shared_ptr<base::Logger> video::BinaryTrackLogSink::m_logger = std::make_shared<base::Logger>();
+std::shared_ptr<base::Logger> video::VideoWriterSink::m_logger = std::make_shared<base::Logger>();
+
+namespace video {
+
+namespace {
+
+void
+WriteAttribute(std::ostream& os, const char* name, const std::optional<dl::AttributeEstimation>& attribute) {
+	if (!attribute.has_value())
+		return;
+	os << ",\"" << name << "\":{\"label\":\"" << base::String::EscapeJson(std::string(attribute->label)) << "\",\"probability\":" << attribute->probability << "}";
+}
+
+}
+
+void
+TrackingRenderer::Render(cv::Mat& image, const TrackingFrame& frame) {
+	for (const auto& det : frame.results) {
+		cv::rectangle(image, det.bbox, cv::Scalar(255, 0, 0));
+		cv::putText(image, "#" + std::to_string(det.trackId), cv::Point(det.bbox.x, det.bbox.y - 5), 1, 1, cv::Scalar(0, 0, 255));
+		if (det.objClass.has_value())
+			cv::putText(image, det.objClass.value(), cv::Point(det.bbox.x, det.bbox.y), 1, 1, cv::Scalar(0, 255, 0));
+		if (det.confidence.has_value())
+			cv::putText(image, std::to_string(det.confidence.value()), cv::Point(det.bbox.x, det.bbox.y + 10), 1, 1, cv::Scalar(0, 255, 0));
+		if (det.ageEstimation.has_value())
+			cv::putText(image, std::string(det.ageEstimation.value().label), cv::Point(det.bbox.x, det.bbox.y + 20), 1, 1, cv::Scalar(0, 255, 0));
+		if (det.genderEstimation.has_value())
+			cv::putText(image, std::string(det.genderEstimation.value().label), cv::Point(det.bbox.x, det.bbox.y + 30), 1, 1, cv::Scalar(0, 255, 0));
+		if (det.ethnicityEstimation.has_value())
+			cv::putText(image, std::string(det.ethnicityEstimation.value().label), cv::Point(det.bbox.x, det.bbox.y + 40), 1, 1, cv::Scalar(0, 255, 0));
+		if (det.drawingElement.has_value() && frame.masksValid)
+			dl::DetectionRenderer::DrawMask(image, det.drawingElement.value());
+	}
+}
+
+JsonLinesSink::JsonLinesSink(const std::string& path)
+	: m_file(path) {
+	if (!m_file.is_open()) {
+		std::string msg = "Could not open JSON lines file " + path;
+		m_logger->LogError(msg.c_str());
+	}
+}
+
+bool
+JsonLinesSink::Write(const TrackingFrame& frame) {
+	if (!m_file.is_open())
+		return true;
+	m_file << "{\"frame\":" << frame.index << ",\"tracks\":[";
+	for (size_t i = 0; i < frame.results.size(); ++i) {
+		const auto& det = frame.results[i];
+		if (i > 0)
+			m_file << ",";
+		m_file << "{\"id\":" << det.trackId << ",\"bbox\":[" << det.bbox.x << "," << det.bbox.y << "," << det.bbox.width << "," << det.bbox.height << "]";
+		if (det.confidence.has_value())
+			m_file << ",\"confidence\":" << det.confidence.value();
+		if (det.objClass.has_value())
+			m_file << ",\"class\":\"" << base::String::EscapeJson(det.objClass.value()) << "\"";
+		WriteAttribute(m_file, "age", det.ageEstimation);
+		WriteAttribute(m_file, "gender", det.genderEstimation);
+		WriteAttribute(m_file, "ethnicity", det.ethnicityEstimation);
+		m_file << "}";
+	}
+	// no endl, flushing every line would cost more than the tracking of a frame
+	m_file << "]}\n";
+	return true;
+}
+
+void
+JsonLinesSink::Close() {
+	if (m_file.is_open())
+		m_file.close();
+}
+
+BinaryTrackLogSink::BinaryTrackLogSink(const std::string& path)
+	: m_file(path, std::ios::binary) {
+	if (!m_file.is_open()) {
+		std::string msg = "Could not open track log " + path;
+		m_logger->LogError(msg.c_str());
+		return;
+	}
+	m_file.write("TRKL", 4);
+	WriteValue<uint32_t>(VERSION);
+}
+
+bool
+BinaryTrackLogSink::Write(const TrackingFrame& frame) {
+	if (!m_file.is_open())
+		return true;
+	WriteValue<uint64_t>(frame.index);
+	WriteValue<uint32_t>(static_cast<uint32_t>(frame.results.size()));
+	for (const auto& det : frame.results) {
+		WriteValue<int32_t>(det.trackId);
+		WriteValue<int32_t>(det.bbox.x);
+		WriteValue<int32_t>(det.bbox.y);
+		WriteValue<int32_t>(det.bbox.width);
+		WriteValue<int32_t>(det.bbox.height);
+		WriteValue<float>(det.confidence.value_or(std::numeric_limits<float>::quiet_NaN()));
+	}
+	return true;
+}
+
+void
+BinaryTrackLogSink::Close() {
+	if (m_file.is_open())
+		m_file.close();
+}
+
+VideoWriterSink::VideoWriterSink(const std::string& path, double fps, int fourcc)
+	: m_path(path), m_fps(fps), m_fourcc(fourcc) {}
+
+bool
+VideoWriterSink::Write(const TrackingFrame& frame) {
+	if (!m_writer.isOpened()) {
+		if (!m_writer.open(m_path, m_fourcc, m_fps, frame.image.size())) {
+			std::string msg = "Could not open video writer " + m_path;
+			m_logger->LogError(msg.c_str());
+			return false;
+		}
+	}
+	frame.image.copyTo(m_drawImage);
+	TrackingRenderer::Render(m_drawImage, frame);
+	m_writer.write(m_drawImage);
+	return true;
+}
+
+void
+VideoWriterSink::Close() {
+	m_writer.release();
+}
+
+bool
+DisplaySink::Write(const TrackingFrame& frame) {
+	frame.image.copyTo(m_drawImage);
+	TrackingRenderer::Render(m_drawImage, frame);
+	cv::imshow(m_windowName, m_drawImage);
+	char c = (char)cv::waitKey(m_waitMs);
+	return c != 27;
+}
+
+void
+DisplaySink::Close() {
+	cv::destroyWindow(m_windowName);
+}
+
+}
\ No newline at end of file
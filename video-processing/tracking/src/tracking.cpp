@@ -1,24 +1,57 @@
 #include <logger/logger.h>
 #include <assertion/assertion.h>
 #include <file/file.h>
+#include <object-detection/non-maximum-suppression.h>
+#include <detection-pipeline/detection-batcher.h>
 
 
+#include <chrono>
+
 #include "tracking/tracking.h"
 
 std::shared_ptr<base::Logger> video::Tracker::m_logger = std::make_shared<base::Logger>();
 
 namespace video {
 
+namespace {
+
+double
+ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+Tracker::Tracker(int redetectSteps, std::shared_ptr<base::ThreadPool> pool)
+    : m_trackerManager(pool) {
+    auto params = m_scheduler.GetParameters();
+    params.interval = redetectSteps;
+    m_scheduler.SetParameters(params);
+}
+
 void
 Tracker::AppendFaceDetector(std::shared_ptr<dl::FaceDetector> detector) {
     auto pair = std::make_pair(dl::Object::FACE, detector);
     m_detectors.emplace_back(std::move(pair));
+    m_batchers.emplace_back(nullptr);
 }
 
 void
 Tracker::AppendInstanceSegmentator(std::shared_ptr<dl::InstanceSegmentator> segmentator) {
     auto pair = std::make_pair(dl::Object::INSTANCE_SEGMENTATION, segmentator);
     m_detectors.emplace_back(std::move(pair));
+    m_batchers.emplace_back(nullptr);
+}
+
+void
+Tracker::SetDetectionBatcher(std::shared_ptr<dl::DetectionBatcher> batcher) {
+    for (size_t d = 0; d < m_detectors.size(); ++d) {
+        if (m_detectors[d].second == batcher->GetDetector()) {
+            m_batchers[d] = batcher;
+            return;
+        }
+    }
+    m_logger->LogWarn("Detection batcher does not belong to any detector of the tracker, ignoring it ...");
 }
 
 std::vector<TrackingResult>
@@ -44,233 +77,243 @@ Tracker::ApplyDetectionOnSingleFrame(const cv::Mat& image) {
     }
     for (const auto& dets : detectionResults) {
         for (const auto& det : dets.detections) {
-            TrackingResult res;
-            res.bbox = det.bbox;
-            res.confidence = det.confidence;
-            if (det.objectClassString.has_value())
-                res.objClass = det.objectClassString;
-            if (det.ageEstimation.has_value())
-                res.ageEstimation = det.ageEstimation;
-            if (det.genderEstimation.has_value())
-                res.genderEstimation = det.genderEstimation;
-            if (det.ethnicityEstimation.has_value())
-                res.ethnicityEstimation = det.ethnicityEstimation;
-            if (det.drawingElement.has_value()) {
+            if (det.drawingElement.has_value())
                 m_segmentationDrawing = true;
-                res.drawingElement = det.drawingElement;
-            }
-            results.emplace_back(std::move(res));
+            results.emplace_back(ConvertDetection(det));
         }
     }
-    m_lastNumberOfObjects = results.size();
-    m_lastTrackingResults = results;
     return results;
 }
 
 bool
 Tracker::AppendTracker(std::vector<TrackerType> types, const cv::Mat& initialImage, std::vector<TrackingResult>& initialDetectionResults) {
-    std::vector<cv::Rect> ROIs;
-    if (!initialDetectionResults.empty()) {
-        ASSERT(types.size() == initialDetectionResults.size(), "Size of vectors of tracker types and initial detection results must be equal",
-            base::Logger::Severity::Error);
-        for (auto result : initialDetectionResults) {
-            ROIs.push_back(result.bbox);
-        }
+    if (initialDetectionResults.empty())
+        return false;
+    ASSERT(types.size() == initialDetectionResults.size(), "Size of vectors of tracker types and initial detection results must be equal",
+        base::Logger::Severity::Error);
+
+    // tracks started later use the type of the first one
+    m_trackerType = types.front();
+    for (size_t i = 0; i < initialDetectionResults.size(); ++i) {
+        auto& result = initialDetectionResults[i];
+        result.trackId = m_associator.AddTrack(result);
+        m_trackerManager.Respawn(result.trackId, types[i], initialImage, result.bbox);
     }
+    return true;
+}
 
-    auto CreateTrackerByName = [](TrackerType type) -> cv::Ptr<cv::Tracker> {
-        switch (type) {
-        case TrackerType::BOOSTING:
-        {
-            return cv::TrackerBoosting::create();
-        }
-        case TrackerType::CSRT:
-        {
-            return cv::TrackerCSRT::create();
-        }
-        case TrackerType::GOTURN:
-        {
-            return cv::TrackerGOTURN::create();
-        }
-        case TrackerType::KCF:
-        {
-            return cv::TrackerKCF::create();
-        }
-        case TrackerType::MEDIANFLOW:
-        {
-            return cv::TrackerMedianFlow::create();
-        }
-        case TrackerType::MIL:
-        {
-            return cv::TrackerMIL::create();
-        }
-        case TrackerType::MOSSE:
-        {
-            return cv::TrackerMOSSE::create();
-        }
-        case TrackerType::TLD:
-        {
-            return cv::TrackerTLD::create();
-        }
-        default:
-        {
-            return nullptr;
-        }
+std::vector<TrackingResult>
+Tracker::PushFrame(cv::Mat& image) {
+    auto start = std::chrono::steady_clock::now();
+    // set again by the detections of this frame that carry masks
+    m_segmentationDrawing = false;
+    for (int trackId : m_associator.Predict()) {
+        m_trackerManager.Remove(trackId);
+        m_scheduler.OnTrackRemoved(trackId);
+    }
+
+    // the visual trackers measure their tracks on every frame, the tracks of the failed ones coast on their Kalman
+    // filter until the scheduler looks for them again
+    std::vector<int> failed;
+    for (const auto& [trackId, box] : m_trackerManager.Update(image, failed))
+        m_associator.Correct(trackId, box);
+
+    auto tracks = m_associator.GetResults();
+    if (tracks.empty()) {
+        DetectAndAssociate(image);
+        m_scheduler.OnFullDetection(m_associator.GetResults(), ElapsedMs(start));
+        return m_associator.GetResults();
+    }
+
+    auto decision = m_scheduler.Schedule(tracks, failed, ElapsedMs(start));
+    if (decision.full && failed.empty() && m_motionGate.GetParameters().enabled) {
+        std::vector<cv::Rect> regions;
+        if (!m_motionGate.Update(image, regions)) {
+            m_scheduler.Postpone();
+            decision.full = false;
+            m_logger->LogDebug("Scene did not change since the last detection, keeping the trackers ...");
         }
-    };
-
-    // initialize the tracker
-    std::vector<cv::Rect2d> objects;
-    std::vector<cv::Ptr<cv::Tracker>> algorithms;
-    m_trackerTypes.clear();
-    for (size_t i = 0; i < ROIs.size(); ++i) {
-        algorithms.push_back(CreateTrackerByName(types[i]));
-        objects.push_back(ROIs[i]);
-        m_trackerTypes.push_back(types[i]);
     }
 
-    if (!ROIs.empty()) {
-        m_multiTracker->add(algorithms, initialImage, objects);
-        return true;
+    if (decision.full) {
+        if (failed.empty())
+            m_logger->LogCritical("Redetecting with neural network ...");
+        else
+            m_logger->LogCritical("Visual tracker update failed, triggering the neural network for a new detection ...");
+        auto detectionStart = std::chrono::steady_clock::now();
+        DetectAndAssociate(image);
+        m_scheduler.OnFullDetection(m_associator.GetResults(), ElapsedMs(detectionStart));
     }
     else {
-        return false;
+        for (int trackId : decision.regionTracks) {
+            auto detectionStart = std::chrono::steady_clock::now();
+            DetectRegionAndAssociate(image, trackId);
+            auto track = m_associator.FindTrack(trackId);
+            if (track)
+                m_scheduler.OnRegionDetection(trackId, track->result.bbox, ElapsedMs(detectionStart));
+        }
     }
+    return m_associator.GetResults();
 }
 
-std::vector<TrackingResult>
-Tracker::PushFrame(cv::Mat& image) {
-    auto EqualizeTrackerTypeVector = [&](size_t size) {
-        if (m_trackerTypes.size() < size) {
-            size_t diff = size - m_trackerTypes.size();
-            for (size_t i = 0; i < diff; ++i) {
-                m_trackerTypes.push_back(m_trackerTypes[i % m_trackerTypes.size()]);
-            }
-        }
-    };
-    std::vector<TrackingResult> retVal;
-    static int counter = 1;
-    bool ok = m_multiTracker->update(image);
-    if (counter % 30 == 0) {
-        counter = 1;
-        m_logger->LogCritical("Redetecting with neural network every 30th frame ...");
-        auto detections = ApplyDetectionOnSingleFrame(image);
-        if (!detections.empty()) {
-            m_multiTracker->clear();
-            m_multiTracker = cv::MultiTracker::create();
-            EqualizeTrackerTypeVector(detections.size());
-            if (AppendTracker(m_trackerTypes, image, detections))
-                return PushFrame(image);
-        }
-    }
-    else if (ok) {
-        counter++;
-        auto objects = m_multiTracker->getObjects();
-        if (objects.size() == m_lastNumberOfObjects && objects.size() == m_lastTrackingResults.size()) {
-            for (size_t i = 0; i < objects.size(); ++i) {
-                TrackingResult res;
-                res.bbox = objects[i];
-                if (m_lastTrackingResults[i].confidence.has_value())
-                    res.confidence = m_lastTrackingResults[i].confidence.value();
-                if (m_lastTrackingResults[i].objClass.has_value())
-                    res.objClass = m_lastTrackingResults[i].objClass.value();
-                if (m_lastTrackingResults[i].ageEstimation.has_value())
-                    res.ageEstimation = m_lastTrackingResults[i].ageEstimation.value();
-                if (m_lastTrackingResults[i].genderEstimation.has_value())
-                    res.genderEstimation = m_lastTrackingResults[i].genderEstimation.value();
-                if (m_lastTrackingResults[i].ethnicityEstimation.has_value())
-                    res.ethnicityEstimation = m_lastTrackingResults[i].ethnicityEstimation.value();
-                if (m_lastTrackingResults[i].drawingElement.has_value())
-                    res.drawingElement = m_lastTrackingResults[i].drawingElement.value();
-                retVal.emplace_back(std::move(res));
-            }
+void
+Tracker::DetectAndAssociate(const cv::Mat& image) {
+    // the attribute networks are left out here, they only run for the tracks that turn out to be new
+    std::vector<dl::DetectionContext> contexts(m_detectors.size());
+    std::vector<TrackingResult> detections;
+    std::vector<std::pair<size_t, size_t>> origins;
+    for (size_t d = 0; d < m_detectors.size(); ++d) {
+        auto& context = contexts[d];
+        context.frame = image;
+        if (m_detectors[d].first == dl::Object::FACE)
+            context.oneClassNetwork = dl::Object::FACE;
+        if (m_batchers[d]) {
+            m_batchers[d]->Detect(context);
         }
         else {
-            for (auto object : objects) {
-                TrackingResult res;
-                res.bbox = object;
-                retVal.emplace_back(std::move(res));
-            }
-            m_lastNumberOfObjects = objects.size();
+            auto& detector = m_detectors[d].second;
+            detector->Preprocess(context);
+            detector->Forward(context);
+            detector->Postprocess(context);
+        }
+        for (size_t i = 0; i < context.result.detections.size(); ++i) {
+            const auto& det = context.result.detections[i];
+            if (det.drawingElement.has_value())
+                m_segmentationDrawing = true;
+            detections.emplace_back(ConvertDetection(det));
+            origins.emplace_back(d, i);
         }
     }
-    else {
-        counter = 1;
-        m_logger->LogCritical("Multi tracker update failed, triggering the neural network for initial detection ...");
-        auto detections = ApplyDetectionOnSingleFrame(image);
-        if (!detections.empty()) {
-            m_multiTracker->clear();
-            m_multiTracker = cv::MultiTracker::create();
-            EqualizeTrackerTypeVector(detections.size());
-            if (AppendTracker(m_trackerTypes, image, detections))
-                return PushFrame(image);
+
+    auto association = m_associator.Associate(detections);
+    for (const auto& [trackId, index] : association.matches)
+        RefreshVisualTracker(trackId, image, detections[index].bbox);
+    // unmatched tracks coast on their Kalman filter until they are found again or age out
+    for (int trackId : association.unmatched)
+        m_trackerManager.Remove(trackId);
+
+    std::vector<dl::DetectionContext> estimations(m_detectors.size());
+    std::vector<std::vector<int>> estimatedTracks(m_detectors.size());
+    for (const auto& [trackId, index] : association.created) {
+        const auto [d, i] = origins[index];
+        estimations[d].result.detections.push_back(contexts[d].result.detections[i]);
+        estimatedTracks[d].push_back(trackId);
+        m_trackerManager.Respawn(trackId, m_trackerType, image, detections[index].bbox);
+    }
+    for (size_t d = 0; d < m_detectors.size(); ++d) {
+        if (estimatedTracks[d].empty())
+            continue;
+        auto& estimation = estimations[d];
+        estimation.frame = image;
+        m_detectors[d].second->EstimateAttributes(estimation);
+        for (size_t k = 0; k < estimatedTracks[d].size(); ++k) {
+            auto track = m_associator.FindTrack(estimatedTracks[d][k]);
+            if (!track)
+                continue;
+            const auto& det = estimation.result.detections[k];
+            track->result.ageEstimation = det.ageEstimation;
+            track->result.genderEstimation = det.genderEstimation;
+            track->result.ethnicityEstimation = det.ethnicityEstimation;
         }
     }
-    return retVal;
 }
 
 void
-Tracker::Run(cv::VideoCapture& cap) {
-    bool first = true;
+Tracker::DetectRegionAndAssociate(const cv::Mat& image, int trackId) {
+    auto track = m_associator.FindTrack(trackId);
+    if (!track)
+        return;
+    auto region = m_scheduler.CalculateRegion(track->result.bbox, image.size());
+    if (region.empty())
+        return;
 
-    while (true) {
-        cv::Mat frame;
-        cap >> frame;
-        if (frame.empty())
-            break;
-        cv::Mat drawImage;
-        frame.copyTo(drawImage);
-
-        if (first) {
-            auto detectionResults = ApplyDetectionOnSingleFrame(frame);
-            if (detectionResults.empty()) {
-                std::cout << "Waiting for first frame with a face object" << std::endl;
-            }
-            else {
-                std::vector<video::TrackerType> types;
-                for (auto det : detectionResults) {
-                    types.push_back(video::TrackerType::KCF);
-                }
-                if (AppendTracker(types, frame, detectionResults))
-                    first = false;
-            }
-        }
-        else {
-            auto detections = PushFrame(frame);
-            for (auto& det : detections) {
-                cv::rectangle(drawImage, det.bbox, cv::Scalar(255, 0, 0));
-                if (det.objClass.has_value())
-                    cv::putText(drawImage, det.objClass.value(), cv::Point(det.bbox.x, det.bbox.y), 1, 1, cv::Scalar(0, 255, 0));
-                if (det.confidence.has_value())
-                    cv::putText(drawImage, std::to_string(det.confidence.value()), cv::Point(det.bbox.x, det.bbox.y + 10), 1, 1, cv::Scalar(0, 255, 0));
-                if (det.ageEstimation.has_value())
-                    cv::putText(drawImage, det.ageEstimation.value(), cv::Point(det.bbox.x, det.bbox.y + 20), 1, 1, cv::Scalar(0, 255, 0));
-                if (det.genderEstimation.has_value())
-                    cv::putText(drawImage, det.genderEstimation.value(), cv::Point(det.bbox.x, det.bbox.y + 30), 1, 1, cv::Scalar(0, 255, 0));
-                if (det.ethnicityEstimation.has_value())
-                    cv::putText(drawImage, det.ethnicityEstimation.value(), cv::Point(det.bbox.x, det.bbox.y + 40), 1, 1, cv::Scalar(0, 255, 0));
-                if (det.drawingElement.has_value()) {
-                    if (m_segmentationDrawing) {
-                        auto& e = det.drawingElement.value();
-                        e.coloredRoi.copyTo(drawImage(e.bbox), e.mask);
-                    }
-                }
+    std::vector<TrackingResult> detections;
+    for (const auto& detector : m_detectors) {
+        dl::DetectionContext context;
+        context.frame = image(region);
+        if (detector.first == dl::Object::FACE)
+            context.oneClassNetwork = dl::Object::FACE;
+        detector.second->Preprocess(context);
+        detector.second->Forward(context);
+        detector.second->Postprocess(context);
+        // the boxes and masks come out in region coordinates
+        for (const auto& det : context.result.detections) {
+            auto result = ConvertDetection(det);
+            result.bbox += region.tl();
+            if (result.drawingElement.has_value()) {
+                m_segmentationDrawing = true;
+                result.drawingElement->bbox += region.tl();
+                result.drawingElement->mask.Translate(region.tl());
             }
+            detections.emplace_back(std::move(result));
         }
+    }
 
-        cv::imshow("Webcam with Face Detections", drawImage);
-        if (m_segmentationDrawing) {
-            m_segmentationDrawing = false;
-            cv::waitKey(1000);
-        }
+    auto association = m_associator.AssociateRegion(detections, region);
+    for (const auto& [matchedId, index] : association.matches)
+        RefreshVisualTracker(matchedId, image, detections[index].bbox);
+    for (int unmatchedId : association.unmatched)
+        m_trackerManager.Remove(unmatchedId);
+}
+
+void
+Tracker::RefreshVisualTracker(int trackId, const cv::Mat& image, const cv::Rect& box) {
+    // a visual tracker that still follows its object is kept, initializing one costs more than its update
+    if (!m_trackerManager.Contains(trackId) ||
+        dl::NonMaximumSuppression::IntersectionOverUnion(m_trackerManager.GetBox(trackId), box) < m_reinitializeIou)
+        m_trackerManager.Respawn(trackId, m_trackerType, image, box);
+}
 
-        char c = (char)cv::waitKey(25);
-        if (c == 27)
+TrackingResult
+Tracker::ConvertDetection(const dl::Detection& det) {
+    TrackingResult res;
+    res.bbox = det.bbox;
+    res.confidence = det.confidence;
+    if (det.objectClassString.has_value())
+        res.objClass = det.objectClassString;
+    if (det.ageEstimation.has_value())
+        res.ageEstimation = det.ageEstimation;
+    if (det.genderEstimation.has_value())
+        res.genderEstimation = det.genderEstimation;
+    if (det.ethnicityEstimation.has_value())
+        res.ethnicityEstimation = det.ethnicityEstimation;
+    if (det.drawingElement.has_value())
+        res.drawingElement = det.drawingElement;
+    return res;
+}
+
+void
+Tracker::SetMotionGating(const dl::MotionGatingParameters& params) {
+    m_motionGate.SetParameters(params);
+}
+
+void
+Tracker::Run(cv::VideoCapture& cap, const std::vector<std::shared_ptr<TrackingSink>>& sinks) {
+    size_t index = 0;
+    bool running = true;
+    while (running) {
+        TrackingFrame frame;
+        if (!cap.read(frame.image) || frame.image.empty())
             break;
+        frame.index = index++;
+        frame.results = PushFrame(frame.image);
+        frame.masksValid = m_segmentationDrawing;
+        for (const auto& sink : sinks)
+            running = sink->Write(frame) && running;
     }
+    for (const auto& sink : sinks)
+        sink->Close();
 
     cap.release();
-    cv::destroyAllWindows();
+    if (m_motionGate.GetParameters().enabled)
+        m_motionGate.LogStatistics();
+    m_trackerManager.LogStatistics();
+    m_scheduler.LogStatistics();
+}
+
+void
+Tracker::Run(cv::VideoCapture& cap) {
+    Run(cap, { std::make_shared<DisplaySink>("Webcam with Face Detections") });
 }
 
 }
\ No newline at end of file
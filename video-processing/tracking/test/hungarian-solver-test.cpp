@@ -0,0 +1,157 @@
+#include <catch2/catch.hpp>
+#include <tracking/hungarian-solver.h>
+#include <logger/logger.h>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+auto hungarianLogger = std::make_shared<base::Logger>();
+
+namespace {
+
+double
+AssignmentCost(const std::vector<double>& cost, int cols, const std::vector<int>& assignment) {
+	double retVal = 0.0;
+	for (size_t i = 0; i < assignment.size(); ++i)
+		if (assignment[i] >= 0)
+			retVal += cost[i * cols + assignment[i]];
+	return retVal;
+}
+
+// every row gets a distinct column, as many pairs as the smaller side allows
+bool
+IsComplete(const std::vector<int>& assignment, int rows, int cols) {
+	if (static_cast<int>(assignment.size()) != rows)
+		return false;
+	std::vector<char> used(cols, 0);
+	int assigned = 0;
+	for (int column : assignment) {
+		if (column < 0)
+			continue;
+		if (column >= cols || used[column])
+			return false;
+		used[column] = 1;
+		++assigned;
+	}
+	return assigned == std::min(rows, cols);
+}
+
+// reference by trying every injective mapping of the smaller side into the larger one
+double
+BruteForceCost(const std::vector<double>& cost, int rows, int cols) {
+	const bool transposed = rows > cols;
+	const int n = transposed ? cols : rows;
+	const int m = transposed ? rows : cols;
+	std::vector<int> columns(m);
+	std::iota(columns.begin(), columns.end(), 0);
+	double best = std::numeric_limits<double>::infinity();
+	do {
+		double current = 0.0;
+		for (int i = 0; i < n; ++i)
+			current += transposed ? cost[static_cast<size_t>(columns[i]) * cols + i] : cost[static_cast<size_t>(i) * cols + columns[i]];
+		best = std::min(best, current);
+	} while (std::next_permutation(columns.begin(), columns.end()));
+	return best;
+}
+
+std::vector<double>
+CreateCost(int rows, int cols, uint32_t seed) {
+	std::vector<double> retVal(static_cast<size_t>(rows) * cols);
+	for (auto& value : retVal) {
+		seed = seed * 1664525u + 1013904223u;
+		value = (seed >> 16) % 100 / 10.0;
+	}
+	return retVal;
+}
+
+}
+
+TEST_CASE("Hungarian Solver Square") {
+	hungarianLogger << MESSAGE("Hungarian Solver Square Test", base::Logger::Severity::Info);
+	// the greedy choice of row 0 (column 0) is not the optimum
+	const std::vector<double> cost = {
+		1.0, 2.0, 9.0,
+		2.0, 9.0, 9.0,
+		9.0, 9.0, 1.0
+	};
+	std::vector<int> assignment;
+	video::HungarianSolver::Solve(cost, 3, 3, assignment);
+	CHECK(assignment == std::vector<int>{ 1, 0, 2 });
+	CHECK(AssignmentCost(cost, 3, assignment) == Approx(5.0));
+
+	for (uint32_t seed = 1; seed <= 20; ++seed) {
+		auto random = CreateCost(5, 5, seed);
+		video::HungarianSolver::Solve(random, 5, 5, assignment);
+		REQUIRE(IsComplete(assignment, 5, 5));
+		CHECK(AssignmentCost(random, 5, assignment) == Approx(BruteForceCost(random, 5, 5)));
+	}
+}
+
+TEST_CASE("Hungarian Solver Wide") {
+	hungarianLogger << MESSAGE("Hungarian Solver Wide Test", base::Logger::Severity::Info);
+	// more columns than rows, every row is assigned and two columns stay free
+	const std::vector<double> cost = {
+		5.0, 1.0, 7.0, 3.0,
+		4.0, 2.0, 8.0, 0.5
+	};
+	std::vector<int> assignment;
+	video::HungarianSolver::Solve(cost, 2, 4, assignment);
+	CHECK(assignment == std::vector<int>{ 1, 3 });
+
+	for (uint32_t seed = 1; seed <= 20; ++seed) {
+		auto random = CreateCost(3, 6, seed);
+		video::HungarianSolver::Solve(random, 3, 6, assignment);
+		REQUIRE(IsComplete(assignment, 3, 6));
+		CHECK(AssignmentCost(random, 6, assignment) == Approx(BruteForceCost(random, 3, 6)));
+	}
+}
+
+TEST_CASE("Hungarian Solver Tall") {
+	hungarianLogger << MESSAGE("Hungarian Solver Tall Test", base::Logger::Severity::Info);
+	// more rows than columns, the rows left over get -1
+	const std::vector<double> cost = {
+		5.0, 4.0,
+		1.0, 2.0,
+		7.0, 8.0,
+		3.0, 0.5
+	};
+	std::vector<int> assignment;
+	video::HungarianSolver::Solve(cost, 4, 2, assignment);
+	CHECK(assignment == std::vector<int>{ -1, 0, -1, 1 });
+
+	for (uint32_t seed = 1; seed <= 20; ++seed) {
+		auto random = CreateCost(6, 3, seed);
+		video::HungarianSolver::Solve(random, 6, 3, assignment);
+		REQUIRE(IsComplete(assignment, 6, 3));
+		CHECK(AssignmentCost(random, 3, assignment) == Approx(BruteForceCost(random, 6, 3)));
+	}
+}
+
+TEST_CASE("Hungarian Solver Ties And Empty") {
+	hungarianLogger << MESSAGE("Hungarian Solver Ties And Empty Test", base::Logger::Severity::Info);
+	// with equal costs any complete assignment is optimal
+	std::vector<int> assignment;
+	const std::vector<double> equal(12, 1.0);
+	video::HungarianSolver::Solve(equal, 3, 4, assignment);
+	CHECK(IsComplete(assignment, 3, 4));
+	video::HungarianSolver::Solve(equal, 4, 3, assignment);
+	CHECK(IsComplete(assignment, 4, 3));
+
+	// two optima of the same cost, either is fine as long as the cost is minimal
+	const std::vector<double> tied = {
+		0.0, 0.0, 1.0,
+		0.0, 0.0, 1.0,
+		1.0, 1.0, 0.0
+	};
+	video::HungarianSolver::Solve(tied, 3, 3, assignment);
+	REQUIRE(IsComplete(assignment, 3, 3));
+	CHECK(assignment[2] == 2);
+	CHECK(AssignmentCost(tied, 3, assignment) == Approx(0.0));
+
+	video::HungarianSolver::Solve({}, 0, 3, assignment);
+	CHECK(assignment.empty());
+	video::HungarianSolver::Solve({}, 2, 0, assignment);
+	CHECK(assignment == std::vector<int>{ -1, -1 });
+}
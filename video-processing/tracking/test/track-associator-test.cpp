@@ -0,0 +1,140 @@
+#include <catch2/catch.hpp>
+#include <tracking/track-associator.h>
+#include <logger/logger.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+auto trackAssociatorLogger = std::make_shared<base::Logger>();
+
+namespace {
+
+video::TrackingResult
+CreateDetection(const cv::Rect& bbox, float confidence) {
+	video::TrackingResult retVal;
+	retVal.bbox = bbox;
+	retVal.confidence = confidence;
+	return retVal;
+}
+
+std::vector<std::pair<int, size_t>>
+Sorted(std::vector<std::pair<int, size_t>> pairs) {
+	std::sort(pairs.begin(), pairs.end());
+	return pairs;
+}
+
+}
+
+TEST_CASE("Track Associator Creates Tracks From Confident Detections") {
+	trackAssociatorLogger << MESSAGE("Track Associator Creates Tracks From Confident Detections Test", base::Logger::Severity::Info);
+	video::TrackAssociator associator;
+	// only the detection above highConfidence starts a track, the weak one and the one below lowConfidence do not
+	auto result = associator.Associate({
+		CreateDetection(cv::Rect(10, 10, 40, 40), 0.9f),
+		CreateDetection(cv::Rect(100, 10, 40, 40), 0.3f),
+		CreateDetection(cv::Rect(200, 10, 40, 40), 0.05f)
+	});
+	CHECK(result.matches.empty());
+	CHECK(result.unmatched.empty());
+	CHECK(result.created == std::vector<std::pair<int, size_t>>{ { 1, 0 } });
+	REQUIRE(associator.GetTracks().size() == 1);
+	CHECK(associator.GetResults().front().trackId == 1);
+}
+
+TEST_CASE("Track Associator Two Stage Matching") {
+	trackAssociatorLogger << MESSAGE("Track Associator Two Stage Matching Test", base::Logger::Severity::Info);
+	video::TrackAssociator associator;
+	const cv::Rect first(10, 10, 40, 40), second(100, 10, 40, 40), third(200, 10, 40, 40);
+	auto result = associator.Associate({ CreateDetection(first, 0.9f), CreateDetection(second, 0.9f), CreateDetection(third, 0.9f) });
+	REQUIRE(result.created.size() == 3);
+	associator.Predict();
+
+	// the first track finds a confident detection, the second only a weak one that confirms it in the second stage,
+	// the third only a detection below lowConfidence, the weak detection far away starts nothing and the confident
+	// one far away starts a new track
+	result = associator.Associate({
+		CreateDetection(first + cv::Point(2, 1), 0.8f),
+		CreateDetection(second + cv::Point(1, 2), 0.3f),
+		CreateDetection(third, 0.05f),
+		CreateDetection(cv::Rect(300, 200, 40, 40), 0.3f),
+		CreateDetection(cv::Rect(400, 200, 40, 40), 0.7f)
+	});
+	CHECK(Sorted(result.matches) == std::vector<std::pair<int, size_t>>{ { 1, 0 }, { 2, 1 } });
+	CHECK(result.unmatched == std::vector<int>{ 3 });
+	CHECK(result.created == std::vector<std::pair<int, size_t>>{ { 4, 4 } });
+	REQUIRE(associator.FindTrack(2));
+	CHECK(associator.FindTrack(2)->result.confidence == 0.3f);
+	CHECK(associator.FindTrack(2)->hits == 2);
+	CHECK(associator.FindTrack(3)->hits == 1);
+	associator.Predict();
+
+	// a confident detection takes the track in the first stage even when a weak one overlaps it better, the weak one
+	// is left over and does not start a track
+	result = associator.Associate({
+		CreateDetection(first + cv::Point(8, 8), 0.9f),
+		CreateDetection(first + cv::Point(2, 1), 0.4f)
+	});
+	CHECK(result.matches == std::vector<std::pair<int, size_t>>{ { 1, 0 } });
+	CHECK(result.created.empty());
+	CHECK(associator.GetTracks().size() == 4);
+
+	// boxes below iouThreshold are not paired even though the Hungarian assignment is complete
+	associator.Clear();
+	associator.Associate({ CreateDetection(first, 0.9f) });
+	associator.Predict();
+	result = associator.Associate({ CreateDetection(first + cv::Point(30, 30), 0.9f) });
+	CHECK(result.matches.empty());
+	CHECK(result.unmatched.size() == 1);
+	CHECK(result.created.size() == 1);
+}
+
+TEST_CASE("Track Associator Keeps Id Across Redetection") {
+	trackAssociatorLogger << MESSAGE("Track Associator Keeps Id Across Redetection Test", base::Logger::Severity::Info);
+	video::TrackAssociator associator;
+	video::AssociationParameters params;
+	params.maxAge = 5;
+	associator.SetParameters(params);
+
+	const cv::Rect box(50, 50, 60, 60);
+	auto detection = CreateDetection(box, 0.9f);
+	detection.objClass = "person";
+	auto result = associator.Associate({ detection });
+	REQUIRE(result.created.size() == 1);
+	const int id = result.created.front().first;
+
+	// the object is missed for a few frames, the track coasts on its prediction
+	for (int i = 0; i < 3; ++i) {
+		CHECK(associator.Predict().empty());
+		result = associator.Associate({});
+		CHECK(result.unmatched == std::vector<int>{ id });
+	}
+
+	// the redetection without a class is assigned to the same track, which keeps its class
+	associator.Predict();
+	result = associator.Associate({ CreateDetection(box + cv::Point(3, 2), 0.7f) });
+	CHECK(result.matches == std::vector<std::pair<int, size_t>>{ { id, 0 } });
+	CHECK(result.created.empty());
+	auto results = associator.GetResults();
+	REQUIRE(results.size() == 1);
+	CHECK(results.front().trackId == id);
+	CHECK(results.front().bbox == box + cv::Point(3, 2));
+	CHECK(results.front().objClass == std::string("person"));
+	CHECK(associator.FindTrack(id)->timeSinceUpdate == 0);
+
+	// a redetection of a region only touches the tracks centered in it and never starts a track
+	associator.Predict();
+	result = associator.AssociateRegion({ CreateDetection(box, 0.9f), CreateDetection(cv::Rect(300, 300, 40, 40), 0.9f) }, cv::Rect(0, 0, 200, 200));
+	CHECK(result.matches == std::vector<std::pair<int, size_t>>{ { id, 0 } });
+	CHECK(result.created.empty());
+	result = associator.AssociateRegion({ CreateDetection(box, 0.9f) }, cv::Rect(200, 200, 200, 200));
+	CHECK(result.matches.empty());
+	CHECK(result.unmatched.empty());
+	CHECK(associator.GetTracks().size() == 1);
+
+	// without any detection the track is removed once it is older than maxAge
+	std::vector<int> removed;
+	for (int i = 0; i <= params.maxAge && removed.empty(); ++i)
+		removed = associator.Predict();
+	CHECK(removed == std::vector<int>{ id });
+	CHECK_FALSE(associator.FindTrack(id));
+}